@@ -20,6 +20,12 @@ int main(int argc, char **argv)
     bool enablePruning = argv[3][0] == 'A';
     int depth = 0;
     std::istringstream(argv[4]) >> depth;
+    // Searches without pruning can optionally be split between threads
+    int threads = 1;
+    if (argc > 5)
+    {
+        std::istringstream(argv[5]) >> threads;
+    }
 
     try
     {
@@ -32,6 +38,7 @@ int main(int argc, char **argv)
         }
 
         AutomarkedSolver solver(depth, enablePruning);
+        solver.setThreads(threads);
         std::cout << solver.solve(board) << std::endl;
         std::cout << solver.numberOfNodesExamined() << std::endl;
     }
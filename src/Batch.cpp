@@ -0,0 +1,388 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+
+#include "board.h"
+#include "mainsolver.h"
+#include "tournamentsolver.h"
+
+// Batch analysis of a file of positions. Positions are read in chunks, solved on worker threads that each keep
+// one solver, and written in input order. Only a bounded number of chunks are in flight, so memory use doesn't
+// grow with the input.
+//
+// Text input has a description on each line, optionally followed by the player to move (r or y, default r).
+// Empty lines and lines starting with # are skipped, and other words on a line are ignored, so Bench position
+// files can be read directly. Binary input is a sequence of 8 byte little endian keys from Board::getKey,
+// for the current player to move.
+//
+// Each position gets an output line "<move> <value> <depth> <nodes> <ms>", where the depth is the height of the
+// deepest completed iteration and the value is for the player to move, or "error <message>" if it is invalid.
+
+using namespace ConnectFour;
+using std::string;
+
+/// @brief Options given on the command line.
+struct Options
+{
+    string solver; // m, mw or t
+    int depth;
+    int timeLimit; // Time limit in milliseconds, or 0 for fixed depth searches
+    int threads;
+    int chunkSize; // Positions in each unit of work
+    bool binary;
+    bool clearTable; // Whether to clear the table for each position so that results don't depend on order
+    bool encode; // Whether to write the binary keys of the text input instead of solving
+    string input; // Input file, or empty for stdin
+};
+
+/// @brief Result of solving a single position.
+struct Result
+{
+    string error; // Why the position couldn't be solved, or empty
+    int move;
+    int value;
+    int depth;
+    long long nodes;
+    double milliseconds;
+};
+
+/// @brief A run of consecutive input positions, solved by a single worker.
+struct Chunk
+{
+    std::vector<Board> boards;
+    std::vector<Result> results;
+    bool done;
+};
+
+// Time limit used when searching to a fixed depth, long enough that it is never reached
+static const int unlimitedTime = 1000000000;
+
+/// @class ChunkPipeline
+/// @brief Chunks in input order, from being read until they are written. The reader waits while the pipeline is
+///        full, workers take chunks in order, and the writer waits for the oldest chunk to be done.
+class ChunkPipeline
+{
+public:
+    explicit ChunkPipeline(int maxChunks) : maxChunks(maxChunks), nextWork(0), finished(false) {}
+
+    /// @brief Add a chunk read from the input, waiting until there is room.
+    void push(const std::shared_ptr<Chunk> &chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return static_cast<int>(chunks.size()) < maxChunks; });
+        chunks.push_back(chunk);
+        changed.notify_all();
+    }
+
+    /// @brief Mark the end of the input.
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        changed.notify_all();
+    }
+
+    /// @brief Wait for a chunk that no worker has taken.
+    /// @return The chunk, or null once the input has ended and every chunk is taken.
+    std::shared_ptr<Chunk> takeWork()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return nextWork < chunks.size() || finished; });
+        if (nextWork == chunks.size()) return std::shared_ptr<Chunk>();
+        return chunks[nextWork++];
+    }
+
+    /// @brief Mark a chunk taken by takeWork as solved.
+    void complete(const std::shared_ptr<Chunk> &chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunk->done = true;
+        changed.notify_all();
+    }
+
+    /// @brief Wait for the oldest chunk to be solved and remove it.
+    /// @return The chunk, or null once the input has ended and every chunk is removed.
+    std::shared_ptr<Chunk> takeDone()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return (!chunks.empty() && chunks.front()->done) || (chunks.empty() && finished); });
+        if (chunks.empty()) return std::shared_ptr<Chunk>();
+        std::shared_ptr<Chunk> chunk = chunks.front();
+        chunks.pop_front();
+        --nextWork;
+        changed.notify_all();
+        return chunk;
+    }
+
+private:
+    const int maxChunks;
+    std::deque<std::shared_ptr<Chunk> > chunks;
+    size_t nextWork; // Index in chunks of the first chunk no worker has taken
+    bool finished;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+/// @brief Read the next position from text input.
+/// @return Whether a position was read, with an error message in place of the board if it is invalid.
+static bool readText(std::istream &in, Board &board, string &error)
+{
+    string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream words(line);
+        string description, player;
+        if (!(words >> description) || description[0] == '#') continue;
+        words >> player;
+
+        error.clear();
+        try
+        {
+            board.setFromDescription(description);
+            if (player == "y") board.swap();
+        }
+        catch (std::invalid_argument &e)
+        {
+            error = e.what();
+        }
+        return true;
+    }
+    return false;
+}
+
+/// @brief Read the next position from binary input.
+static bool readBinary(std::istream &in, Board &board, string &error)
+{
+    unsigned char bytes[8];
+    if (!in.read(reinterpret_cast<char *>(bytes), sizeof(bytes))) return false;
+    std::uint64_t key = 0;
+    for (int i = 7; i >= 0; --i)
+    {
+        key = (key << 8) | bytes[i];
+    }
+
+    error.clear();
+    try
+    {
+        board.setFromKey(key);
+    }
+    catch (std::invalid_argument &e)
+    {
+        error = e.what();
+    }
+    return true;
+}
+
+/// @brief Write the binary key of each position in text input.
+static int encodeKeys(std::istream &in, std::ostream &out)
+{
+    Board board;
+    string error;
+    while (readText(in, board, error))
+    {
+        if (!error.empty())
+        {
+            std::cerr << "Invalid position: " << error << std::endl;
+            return -1;
+        }
+        std::uint64_t key = board.getKey();
+        unsigned char bytes[8];
+        for (int i = 0; i < 8; ++i, key >>= 8)
+        {
+            bytes[i] = static_cast<unsigned char>(key);
+        }
+        out.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+    }
+    return 0;
+}
+
+/// @brief Solve every position in the chunks taken from the pipeline with a single solver.
+template <class SolverType>
+static void work(ChunkPipeline &pipeline, const Options &options)
+{
+    int time = options.timeLimit > 0 ? options.timeLimit : unlimitedTime;
+    int maxDepth = options.timeLimit > 0 ? -1 : options.depth;
+    SolverType solver(time, 1, 1, maxDepth);
+    solver.setKeepTable(!options.clearTable);
+
+    std::shared_ptr<Chunk> chunk;
+    while ((chunk = pipeline.takeWork()))
+    {
+        for (size_t i = 0; i < chunk->boards.size(); ++i)
+        {
+            Result &result = chunk->results[i];
+            if (!result.error.empty()) continue;
+            const Board &board = chunk->boards[i];
+            if (board.isGameOver())
+            {
+                result.error = "game is over";
+                continue;
+            }
+
+            result.move = solver.solve(board);
+            const SearchStatistics &stats = solver.statistics();
+            result.value = 0;
+            result.depth = 0;
+            for (std::vector<SearchStatistics::Iteration>::const_iterator iteration = stats.iterations.begin(); iteration != stats.iterations.end(); ++iteration)
+            {
+                if (iteration->move != -1 && iteration->height >= result.depth)
+                {
+                    result.depth = iteration->height;
+                    result.value = iteration->value;
+                }
+            }
+            result.nodes = stats.nodes;
+            result.milliseconds = stats.milliseconds;
+        }
+        pipeline.complete(chunk);
+    }
+}
+
+template <class SolverType>
+static void startWorkers(std::vector<std::thread> &threads, ChunkPipeline &pipeline, const Options &options)
+{
+    for (int i = 0; i < options.threads; ++i)
+    {
+        threads.push_back(std::thread(work<SolverType>, std::ref(pipeline), std::cref(options)));
+    }
+}
+
+/// @brief Write the results of chunks in order as they are solved.
+static void writeResults(ChunkPipeline &pipeline, std::ostream &out)
+{
+    std::shared_ptr<Chunk> chunk;
+    while ((chunk = pipeline.takeDone()))
+    {
+        std::ostringstream text;
+        for (std::vector<Result>::const_iterator result = chunk->results.begin(); result != chunk->results.end(); ++result)
+        {
+            if (!result->error.empty())
+            {
+                text << "error " << result->error << '\n';
+            }
+            else
+            {
+                text << result->move << ' ' << result->value << ' ' << result->depth << ' ' << result->nodes << ' '
+                    << result->milliseconds << '\n';
+            }
+        }
+        out << text.str();
+        out.flush();
+    }
+}
+
+static void printUsage()
+{
+    std::cerr << "Usage: Batch [options] [file]" << std::endl
+        << "  -s <solver>   Solver: m, mw or t (default m)" << std::endl
+        << "  -d <depth>    Search depth (default 12)" << std::endl
+        << "  -t <ms>       Time limit per position instead of searching to a fixed depth" << std::endl
+        << "  -j <threads>  Number of worker threads (default the number of hardware threads)" << std::endl
+        << "  -n <count>    Positions in each unit of work (default 64)" << std::endl
+        << "  -b            Read binary keys instead of text descriptions" << std::endl
+        << "  -c            Clear the table for each position, so results don't depend on the order" << std::endl
+        << "  -e            Write the binary keys of the text input to stdout instead of solving" << std::endl
+        << "The positions are read from the file, or stdin if there is none." << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    options.solver = "m";
+    options.depth = 12;
+    options.timeLimit = 0;
+    options.threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    options.chunkSize = 64;
+    options.binary = false;
+    options.clearTable = false;
+    options.encode = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "-s" && hasValue) options.solver = argv[++i];
+        else if (arg == "-d" && hasValue) options.depth = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue) options.timeLimit = std::atoi(argv[++i]);
+        else if (arg == "-j" && hasValue) options.threads = std::atoi(argv[++i]);
+        else if (arg == "-n" && hasValue) options.chunkSize = std::atoi(argv[++i]);
+        else if (arg == "-b") options.binary = true;
+        else if (arg == "-c") options.clearTable = true;
+        else if (arg == "-e") options.encode = true;
+        else if (arg[0] == '-' && arg.size() > 1)
+        {
+            printUsage();
+            return -1;
+        }
+        else options.input = arg;
+    }
+    if (options.depth < 1 || options.timeLimit < 0 || options.threads < 1 || options.chunkSize < 1
+        || (options.solver != "m" && options.solver != "mw" && options.solver != "t"))
+    {
+        printUsage();
+        return -1;
+    }
+
+    std::ifstream file;
+    if (!options.input.empty() && options.input != "-")
+    {
+        file.open(options.input.c_str(), options.binary ? std::ios::binary : std::ios::in);
+        if (!file)
+        {
+            std::cerr << "Unable to open " << options.input << std::endl;
+            return -1;
+        }
+    }
+    std::istream &in = file.is_open() ? file : std::cin;
+    std::ios_base::sync_with_stdio(false);
+
+    if (options.encode)
+    {
+        return encodeKeys(in, std::cout);
+    }
+
+    // Enough chunks that every worker can have one while the oldest is written
+    ChunkPipeline pipeline(4 * options.threads);
+    std::vector<std::thread> threads;
+    if (options.solver == "t") startWorkers<TournamentSolver>(threads, pipeline, options);
+    else if (options.solver == "mw") startWorkers<MainWindowSolver>(threads, pipeline, options);
+    else startWorkers<MainSolver>(threads, pipeline, options);
+    std::thread writer(writeResults, std::ref(pipeline), std::ref(std::cout));
+
+    bool more = true;
+    while (more)
+    {
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+        chunk->done = false;
+        Board board;
+        string error;
+        while (static_cast<int>(chunk->boards.size()) < options.chunkSize
+            && (more = options.binary ? readBinary(in, board, error) : readText(in, board, error)))
+        {
+            Result result = {};
+            result.error = error;
+            chunk->boards.push_back(board);
+            chunk->results.push_back(result);
+        }
+        if (!chunk->boards.empty()) pipeline.push(chunk);
+    }
+    pipeline.finish();
+
+    for (std::vector<std::thread>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+    {
+        thread->join();
+    }
+    writer.join();
+    return 0;
+}
@@ -0,0 +1,587 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "board.h"
+#include "mainsolver.h"
+#include "automarkedsolver.h"
+#include "tournamentsolver.h"
+#include "montecarlosolver.h"
+
+using namespace ConnectFour;
+using std::string;
+
+/// @brief A benchmark position with the moves that are known to be optimal.
+struct Position
+{
+    string description;
+    string optimalMoves; // Columns of every move achieving the best game theoretic result
+    string result; // Game theoretic result for the current player: win, draw or loss
+};
+
+/// @brief Results of running a solver over a set of positions.
+struct SetResult
+{
+    string set;
+    string solver;
+    int positions;
+    int correct; // Number of moves found that are optimal, or -1 if not checked
+    std::vector<double> milliseconds;
+    long long nodes;
+    long long bestMoveChanges; // Iterations that changed the best move, over every solve
+    long long depthTotal; // Heights of the deepest completed iterations, over every solve
+};
+
+/// @brief An AutomarkedSolver search with the move and node count found by the original implementation.
+struct AutomarkedCase
+{
+    string description;
+    int depth;
+    bool prune;
+    int move;
+    long long nodes;
+};
+
+/// @brief Options given on the command line.
+struct Options
+{
+    int depth; // Search depth for MainSolver and TournamentSolver
+    int automarkedDepth;
+    int threads; // Threads for mc, and for AutomarkedSolver searches without pruning
+    int timeLimit; // Time limit in milliseconds, or 0 for deterministic fixed depth searches
+    int repeats;
+    string format;
+    string directory;
+    std::vector<string> solvers;
+    std::vector<string> sets;
+    bool compareMultiPV;
+    bool checkAutomarked; // Check AutomarkedSolver against the regression cases
+    bool playMatch; // Play games between the first two solvers instead of solving the positions
+    int nullMoveReduction; // Reduction for the tn solver
+    int lateMoveReduction; // Reduction for late moves in m, mw, t and tn, or 0 for none
+    int endgameThreshold; // Empty slots at which m switches to an exact search
+    int parityThreshold; // Empty slots at which m and mw score nodes by threat parity
+};
+
+static const char *defaultSets[] = { "opening", "middlegame", "endgame", "hard1", "hard2", "hard3" };
+
+// Time limit used when searching deterministically, long enough that it is never reached
+static const int unlimitedTime = 1000000;
+
+// Time for each mc search without a time limit, as it only stops when the time is up
+static const int defaultMonteCarloTime = 1000;
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Load positions from a file, ignoring blank lines and # comments.
+static std::vector<Position> loadPositions(const string &path)
+{
+    std::ifstream file(path.c_str());
+    if (!file.good())
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    std::vector<Position> positions;
+    string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        Position position;
+        if (iss >> position.description >> position.optimalMoves >> position.result)
+        {
+            positions.push_back(position);
+        }
+    }
+    return positions;
+}
+
+/// @brief Create a solver for the standard game with the options for it.
+template <class SolverType>
+static Solver *createMainSolver(int time, int maxDepth, const Options &options)
+{
+    SolverType *solver = new SolverType(time, 1, 1, maxDepth);
+    solver->setLateMoveReductions(options.lateMoveReduction);
+    solver->setEndgameThreshold(options.endgameThreshold);
+    solver->setParityPruning(options.parityThreshold);
+    return solver;
+}
+
+/// @brief Create a solver from its name. Searches are deterministic unless there is a time limit.
+static Solver *createSolver(const string &name, const Options &options)
+{
+    int time = options.timeLimit > 0 ? options.timeLimit : unlimitedTime;
+    int maxDepth = options.timeLimit > 0 ? -1 : options.depth;
+    if (name == "m")
+    {
+        return createMainSolver<MainSolver>(time, maxDepth, options);
+    }
+    else if (name == "mw")
+    {
+        return createMainSolver<MainWindowSolver>(time, maxDepth, options);
+    }
+    else if (name == "t" || name == "tn")
+    {
+        TournamentSolver *solver = new TournamentSolver(time, 1, 1, maxDepth);
+        solver->setNullMovePruning(name == "tn", options.nullMoveReduction);
+        solver->setLateMoveReductions(options.lateMoveReduction);
+        return solver;
+    }
+    else if (name == "am")
+    {
+        return new AutomarkedSolver(options.automarkedDepth, true);
+    }
+    else if (name == "mc")
+    {
+        return new MonteCarloSolver(options.timeLimit > 0 ? options.timeLimit : defaultMonteCarloTime, options.threads);
+    }
+    throw std::invalid_argument("Unknown solver " + name);
+}
+
+/// @brief Get the height of the deepest iteration that completed.
+static int completedDepth(const SearchStatistics &stats)
+{
+    int depth = 0;
+    for (std::vector<SearchStatistics::Iteration>::const_iterator i = stats.iterations.begin(); i != stats.iterations.end(); ++i)
+    {
+        if (i->move != -1) depth = std::max(depth, i->height);
+    }
+    return depth;
+}
+
+/// @brief Get the value at a percentile of sorted values using the nearest rank.
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(p / 100 * sorted.size() + 0.5);
+    rank = std::max<size_t>(rank, 1);
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+static SetResult runSet(const string &set, const std::vector<Position> &positions, const string &solverName, const Options &options)
+{
+    SetResult result;
+    result.set = set;
+    result.solver = solverName;
+    result.positions = positions.size();
+    // Tournament rules allow passing, so the standard game's optimal moves don't apply
+    result.correct = (solverName[0] == 't') ? -1 : 0;
+    result.nodes = 0;
+    result.bestMoveChanges = 0;
+    result.depthTotal = 0;
+
+    Solver *solver = createSolver(solverName, options);
+    for (std::vector<Position>::const_iterator i = positions.begin(); i != positions.end(); ++i)
+    {
+        Board board;
+        board.setFromDescription(i->description);
+
+        int move = -1;
+        for (int repeat = 0; repeat < options.repeats; ++repeat)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            move = solver->solve(board);
+            result.milliseconds.push_back(millisecondsSince(start));
+            result.nodes += solver->statistics().nodes;
+            result.bestMoveChanges += solver->statistics().bestMoveChanges;
+            result.depthTotal += completedDepth(solver->statistics());
+        }
+
+        if (result.correct != -1 && move >= 0 && move < Board::width && i->optimalMoves.find(char('0' + move)) != string::npos)
+        {
+            ++result.correct;
+        }
+    }
+    delete solver;
+
+    std::sort(result.milliseconds.begin(), result.milliseconds.end());
+    return result;
+}
+
+static void printResult(const SetResult &result, const Options &options, bool first)
+{
+    double total = 0;
+    for (std::vector<double>::const_iterator i = result.milliseconds.begin(); i != result.milliseconds.end(); ++i)
+    {
+        total += *i;
+    }
+    double mean = result.milliseconds.empty() ? 0 : total / result.milliseconds.size();
+    double nps = total > 0 ? result.nodes * 1000.0 / total : 0;
+    long long meanNodes = result.milliseconds.empty() ? 0 : result.nodes / result.milliseconds.size();
+    double meanDepth = result.milliseconds.empty() ? 0 : double(result.depthTotal) / result.milliseconds.size();
+
+    if (options.format == "json")
+    {
+        std::cout << (first ? "" : ",\n")
+            << "{\"set\":\"" << result.set << "\",\"solver\":\"" << result.solver
+            << "\",\"positions\":" << result.positions
+            << ",\"correct\":" << result.correct
+            << ",\"meanMs\":" << mean
+            << ",\"p50Ms\":" << percentile(result.milliseconds, 50)
+            << ",\"p90Ms\":" << percentile(result.milliseconds, 90)
+            << ",\"p99Ms\":" << percentile(result.milliseconds, 99)
+            << ",\"nodes\":" << result.nodes
+            << ",\"meanNodes\":" << meanNodes
+            << ",\"nodesPerSecond\":" << static_cast<long long>(nps)
+            << ",\"bestMoveChanges\":" << result.bestMoveChanges
+            << ",\"meanDepth\":" << meanDepth << "}";
+    }
+    else
+    {
+        std::cout << result.set << " (" << result.solver << "): ";
+        if (result.correct == -1)
+        {
+            std::cout << "correctness not checked";
+        }
+        else
+        {
+            std::cout << result.correct << "/" << result.positions << " correct";
+        }
+        std::cout << ", mean " << mean << " ms, p50/p90/p99 " << percentile(result.milliseconds, 50) << "/"
+            << percentile(result.milliseconds, 90) << "/" << percentile(result.milliseconds, 99) << " ms, "
+            << meanNodes << " nodes, " << static_cast<long long>(nps) << " nodes/s, "
+            << result.bestMoveChanges << " best move changes, mean depth " << meanDepth << std::endl;
+    }
+}
+
+/// @brief Compare MainSolver::analyse against searching each move with a separate solver.
+static void compareMultiPV(const std::vector<std::vector<Position> > &sets, const Options &options)
+{
+    double analyseTime = 0, independentTime = 0;
+    long long analyseNodes = 0, independentNodes = 0;
+    for (std::vector<std::vector<Position> >::const_iterator set = sets.begin(); set != sets.end(); ++set)
+    {
+        for (std::vector<Position>::const_iterator i = set->begin(); i != set->end(); ++i)
+        {
+            Board board;
+            board.setFromDescription(i->description);
+
+            MainSolver solver(unlimitedTime, 1, 1, options.depth);
+            MainSolver::AnalysisArray analysis;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            solver.analyse(board, analysis);
+            analyseTime += millisecondsSince(start);
+            analyseNodes += solver.statistics().nodes;
+
+            // Solve each child position to one less depth, each with a new table
+            start = std::chrono::steady_clock::now();
+            for (int column = 0; column < Board::width; ++column)
+            {
+                if (!board.canPlay(column)) continue;
+                Board child(board);
+                child.play(column);
+                if (child.isWin() || options.depth == 1 || child.totalCount() == Board::width*Board::height) continue;
+                child.swap();
+                MainSolver childSolver(unlimitedTime, 1, 1, options.depth - 1);
+                childSolver.solve(child);
+                independentNodes += childSolver.statistics().nodes;
+            }
+            independentTime += millisecondsSince(start);
+        }
+    }
+
+    if (options.format == "json")
+    {
+        std::cout << "\"multiPV\":{\"analyseMs\":" << analyseTime << ",\"analyseNodes\":" << analyseNodes
+            << ",\"independentMs\":" << independentTime << ",\"independentNodes\":" << independentNodes << "}";
+    }
+    else
+    {
+        std::cout << "Multi-PV analyse: " << analyseTime << " ms, " << analyseNodes << " nodes" << std::endl
+            << "Independent solves: " << independentTime << " ms, " << independentNodes << " nodes" << std::endl
+            << "Speedup: " << (analyseTime > 0 ? independentTime / analyseTime : 0) << "x" << std::endl;
+    }
+}
+
+/// @brief Play a game from a position between two solvers, with the first moving first.
+/// @return 1 if the first solver won, -1 if the second won, or 0 for a draw. A solver that finds no move loses.
+static int playGame(const Position &position, Solver *first, Solver *second)
+{
+    Board board;
+    board.setFromDescription(position.description);
+    Solver *players[2] = { first, second };
+    for (int turn = 0; board.totalCount() < Board::width*Board::height; turn ^= 1)
+    {
+        int move = players[turn]->solve(board);
+        if (move < 0 || move >= Board::width || !board.canPlay(move))
+        {
+            return turn == 0 ? -1 : 1;
+        }
+        board.play(move);
+        if (board.isWin())
+        {
+            return turn == 0 ? 1 : -1;
+        }
+        board.swap();
+    }
+    return 0;
+}
+
+/// @brief Play games between the first two solvers from each position, with each solver moving first in turn.
+static void playMatch(const std::vector<std::vector<Position> > &sets, const Options &options)
+{
+    const string &name = options.solvers[0];
+    const string &opponentName = options.solvers[1];
+    Solver *solver = createSolver(name, options);
+    Solver *opponent = createSolver(opponentName, options);
+
+    // Results for the first solver
+    int wins = 0, draws = 0, losses = 0;
+    for (std::vector<std::vector<Position> >::const_iterator set = sets.begin(); set != sets.end(); ++set)
+    {
+        for (std::vector<Position>::const_iterator i = set->begin(); i != set->end(); ++i)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                int result = side == 0 ? playGame(*i, solver, opponent) : -playGame(*i, opponent, solver);
+                if (result > 0) ++wins;
+                else if (result < 0) ++losses;
+                else ++draws;
+            }
+        }
+    }
+
+    const SearchStatistics &stats = solver->totalStatistics();
+    const SearchStatistics &opponentStats = opponent->totalStatistics();
+    if (options.format == "json")
+    {
+        std::cout << "\"match\":{\"solver\":\"" << name << "\",\"opponent\":\"" << opponentName
+            << "\",\"wins\":" << wins << ",\"draws\":" << draws << ",\"losses\":" << losses
+            << ",\"searches\":" << stats.searches << ",\"nodesPerSecond\":" << stats.nodesPerSecond()
+            << ",\"playoutsPerSecond\":" << stats.playoutsPerSecond()
+            << ",\"opponentSearches\":" << opponentStats.searches << ",\"opponentNodesPerSecond\":" << opponentStats.nodesPerSecond()
+            << ",\"opponentPlayoutsPerSecond\":" << opponentStats.playoutsPerSecond() << "}";
+    }
+    else
+    {
+        std::cout << name << " against " << opponentName << ": " << wins << " wins, " << draws << " draws, "
+            << losses << " losses" << std::endl;
+        const SearchStatistics *allStats[2] = { &stats, &opponentStats };
+        const string *names[2] = { &name, &opponentName };
+        for (int i = 0; i < 2; ++i)
+        {
+            std::cout << *names[i] << ": " << allStats[i]->searches << " searches, mean "
+                << (allStats[i]->searches > 0 ? allStats[i]->milliseconds / allStats[i]->searches : 0) << " ms, "
+                << static_cast<long long>(allStats[i]->nodesPerSecond()) << " nodes/s, "
+                << static_cast<long long>(allStats[i]->playoutsPerSecond()) << " playouts/s" << std::endl;
+        }
+    }
+    delete solver;
+    delete opponent;
+}
+
+/// @brief Load the AutomarkedSolver regression cases from a file, ignoring blank lines and # comments.
+static std::vector<AutomarkedCase> loadAutomarkedCases(const string &path)
+{
+    std::ifstream file(path.c_str());
+    if (!file.good())
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    std::vector<AutomarkedCase> cases;
+    string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        AutomarkedCase c;
+        int prune;
+        if (iss >> c.description >> c.depth >> prune >> c.move >> c.nodes)
+        {
+            c.prune = prune != 0;
+            cases.push_back(c);
+        }
+    }
+    return cases;
+}
+
+/// @brief Check that AutomarkedSolver finds the same move and examines the same number of nodes as the original
+///        implementation for each regression case.
+/// @return Whether every case matched.
+static bool checkAutomarked(const Options &options)
+{
+    std::vector<AutomarkedCase> cases = loadAutomarkedCases(options.directory + "/automarked.txt");
+    int matched = 0;
+    double total = 0;
+    for (std::vector<AutomarkedCase>::const_iterator c = cases.begin(); c != cases.end(); ++c)
+    {
+        Board board;
+        board.setFromDescription(c->description);
+        AutomarkedSolver solver(c->depth, c->prune);
+        solver.setThreads(options.threads);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int move = solver.solve(board);
+        total += millisecondsSince(start);
+
+        if (move == c->move && solver.numberOfNodesExamined() == c->nodes)
+        {
+            ++matched;
+        }
+        else if (options.format != "json")
+        {
+            std::cout << "Mismatch: " << c->description << " depth " << c->depth << (c->prune ? " pruned" : "")
+                << ": move " << move << " nodes " << solver.numberOfNodesExamined()
+                << ", expected move " << c->move << " nodes " << c->nodes << std::endl;
+        }
+    }
+
+    if (options.format == "json")
+    {
+        std::cout << "\"automarked\":{\"cases\":" << cases.size() << ",\"matched\":" << matched << ",\"ms\":" << total << "}";
+    }
+    else
+    {
+        std::cout << "Automarked regression: " << matched << "/" << cases.size() << " match, " << total << " ms" << std::endl;
+    }
+    return matched == static_cast<int>(cases.size());
+}
+
+static void printUsage()
+{
+    std::cerr << "Usage: Bench [options] [sets...]" << std::endl
+        << "  -s <solvers>  Comma separated solvers to run: m, mw, t, tn, am, mc (default m,am)" << std::endl
+        << "                mw is MainSolver with the window evaluation" << std::endl
+        << "                tn is TournamentSolver with null move pruning" << std::endl
+        << "                mc is MonteCarloSolver, searching for the time limit or 1000 ms" << std::endl
+        << "  -d <depth>    Search depth for m, mw and t (default 12)" << std::endl
+        << "  -a <depth>    Search depth for am (default 8)" << std::endl
+        << "  -j <threads>  Threads for mc, and for am searches without pruning as checked by -c (default 1)" << std::endl
+        << "  -n <plies>    Null move reduction for tn (default 2)" << std::endl
+        << "  -l <plies>    Late move reduction for m, mw, t and tn (default 0, disabled)" << std::endl
+        << "  -e <slots>    Empty slots at which m and mw solve exactly (default 20, 0 to disable)" << std::endl
+        << "  -z <slots>    Empty slots at which m and mw score nodes by threat parity (default 0, disabled)" << std::endl
+        << "  -t <ms>       Time limit per position instead of searching to a fixed depth" << std::endl
+        << "  -r <repeats>  Number of times to solve each position (default 1)" << std::endl
+        << "  -f <format>   Output format: text or json (default text)" << std::endl
+        << "  -p <dir>      Directory containing position sets (default bench)" << std::endl
+        << "  -m            Compare multi-PV analysis against independent solves" << std::endl
+        << "  -c            Check AutomarkedSolver moves and node counts against <dir>/automarked.txt" << std::endl
+        << "  -g            Play games between the first two solvers from each position instead of solving them" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    options.depth = 12;
+    options.automarkedDepth = 8;
+    options.threads = 1;
+    options.timeLimit = 0;
+    options.repeats = 1;
+    options.format = "text";
+    options.directory = "bench";
+    options.compareMultiPV = false;
+    options.checkAutomarked = false;
+    options.playMatch = false;
+    options.nullMoveReduction = TournamentSolver::defaultNullMoveReduction;
+    options.lateMoveReduction = 0;
+    options.endgameThreshold = MainSolver::defaultEndgameThreshold;
+    options.parityThreshold = MainSolver::defaultParityThreshold;
+    string solvers = "m,am";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "-s" && hasValue) solvers = argv[++i];
+        else if (arg == "-d" && hasValue) options.depth = std::atoi(argv[++i]);
+        else if (arg == "-a" && hasValue) options.automarkedDepth = std::atoi(argv[++i]);
+        else if (arg == "-j" && hasValue) options.threads = std::atoi(argv[++i]);
+        else if (arg == "-n" && hasValue) options.nullMoveReduction = std::atoi(argv[++i]);
+        else if (arg == "-l" && hasValue) options.lateMoveReduction = std::atoi(argv[++i]);
+        else if (arg == "-e" && hasValue) options.endgameThreshold = std::atoi(argv[++i]);
+        else if (arg == "-z" && hasValue) options.parityThreshold = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue) options.timeLimit = std::atoi(argv[++i]);
+        else if (arg == "-r" && hasValue) options.repeats = std::atoi(argv[++i]);
+        else if (arg == "-f" && hasValue) options.format = argv[++i];
+        else if (arg == "-p" && hasValue) options.directory = argv[++i];
+        else if (arg == "-m") options.compareMultiPV = true;
+        else if (arg == "-c") options.checkAutomarked = true;
+        else if (arg == "-g") options.playMatch = true;
+        else if (arg[0] == '-')
+        {
+            printUsage();
+            return -1;
+        }
+        else options.sets.push_back(arg);
+    }
+    if (options.depth < 1 || options.automarkedDepth < 0 || options.threads < 1 || options.repeats < 1 || options.nullMoveReduction < 0 || options.lateMoveReduction < 0 || options.endgameThreshold < 0 || options.parityThreshold < 0)
+    {
+        printUsage();
+        return -1;
+    }
+
+    std::istringstream solverList(solvers);
+    string solver;
+    while (std::getline(solverList, solver, ','))
+    {
+        options.solvers.push_back(solver);
+    }
+    if (options.sets.empty())
+    {
+        options.sets.assign(defaultSets, defaultSets + sizeof(defaultSets)/sizeof(*defaultSets));
+    }
+
+    try
+    {
+        std::vector<std::vector<Position> > sets;
+        for (std::vector<string>::const_iterator set = options.sets.begin(); set != options.sets.end(); ++set)
+        {
+            sets.push_back(loadPositions(options.directory + "/" + *set + ".txt"));
+        }
+
+        if (options.playMatch)
+        {
+            if (options.solvers.size() < 2)
+            {
+                printUsage();
+                return -1;
+            }
+            if (options.format == "json") std::cout << "{";
+            playMatch(sets, options);
+        }
+        else
+        {
+            if (options.format == "json") std::cout << "{\"results\":[";
+            bool first = true;
+            for (std::vector<string>::const_iterator solver = options.solvers.begin(); solver != options.solvers.end(); ++solver)
+            {
+                for (size_t set = 0; set < sets.size(); ++set)
+                {
+                    printResult(runSet(options.sets[set], sets[set], *solver, options), options, first);
+                    first = false;
+                }
+            }
+            if (options.format == "json") std::cout << "]";
+        }
+
+        if (options.compareMultiPV)
+        {
+            if (options.format == "json") std::cout << ",";
+            compareMultiPV(sets, options);
+        }
+        bool passed = true;
+        if (options.checkAutomarked)
+        {
+            if (options.format == "json") std::cout << ",";
+            passed = checkAutomarked(options);
+        }
+        if (options.format == "json") std::cout << "}" << std::endl;
+        return passed ? 0 : 1;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -6,11 +6,15 @@
 #include <stdexcept>
 #include <array>
 #include <fstream>
+#include <algorithm>
 
 #include "board.h"
 #include "mainsolver.h"
 #include "automarkedsolver.h"
 #include "tournamentsolver.h"
+#include "montecarlosolver.h"
+#include "perft.h"
+#include "playouts.h"
 
 using namespace ConnectFour;
 using std::string;
@@ -156,22 +160,89 @@ void play(int column, bool checkOnly = false)
     }
 }
 
+// Seed the playouts from rand, which is seeded from the time
+static LockstepPlayouts &playouts()
+{
+    static LockstepPlayouts lockstepPlayouts((static_cast<unsigned long long>(std::rand()) << 32) | std::rand() | 1);
+    return lockstepPlayouts;
+}
+
 void random(int pieces)
 {
     if (pieces < 0)
     {
         pieces = std::rand() % (Board::width*Board::height);
     }
-    while (pieces > 0)
+
+    // Play a random game for that many moves, which stops early if the game ends
+    LockstepPlayouts::Game game;
+    playouts().play(board, 1, &game, pieces);
+    for (int i = 0; i < game.length; ++i)
     {
-        int column = std::rand() % Board::width;
-        if (board.canPlay(column))
+        board.play(game.moves[i]);
+        board.swap();
+    }
+}
+
+void runPlayouts(int games)
+{
+    if (games <= 0)
+    {
+        std::cout << "Invalid arguments: <games>" << std::endl;
+        return;
+    }
+
+    LockstepPlayouts::Totals totals = playouts().play(board, games);
+    std::cout << "Wins: " << totals.wins << ", draws: " << totals.draws << ", losses: " << totals.losses << std::endl;
+    std::cout << "Time taken: " << totals.milliseconds << " ms ("
+        << static_cast<long long>(totals.gamesPerSecond()) << " games/s)" << std::endl;
+}
+
+void runPerft(std::istream &args)
+{
+    int depth = -1, threads = 1;
+    string option;
+    args >> depth;
+    bool deduplicate = false;
+    while (args >> option)
+    {
+        if (option == "distinct")
         {
-            board.play(column);
+            deduplicate = true;
+        }
+        else
+        {
+            std::istringstream(option) >> threads;
         }
-        --pieces;
+    }
+    if (depth < 0 || threads < 1)
+    {
+        std::cout << "Invalid arguments: <depth> [distinct] [threads]" << std::endl;
+        return;
+    }
 
-        board.swap();
+    PerftResult result = perft(board, depth, deduplicate, threads);
+    for (int column = 0; column < Board::width; ++column)
+    {
+        std::cout << column << ": " << result.rootLeaves[column] << std::endl;
+    }
+    std::cout << "Leaves: " << result.leaves << ", wins: " << result.wins << std::endl;
+    std::cout << "Time taken: " << result.milliseconds << " ms ("
+        << static_cast<long long>(result.milliseconds > 0 ? result.leaves * 1000.0 / result.milliseconds : 0)
+        << " positions/s)" << std::endl;
+}
+
+// Read the optional late move reduction arguments for a search solver: reduction, then number of full moves
+template <class SearchSolverType>
+void setLateMoveReductions(SearchSolverType *searchSolver, std::istream &args)
+{
+    int reduction = 0, fullMoves = SearchSolverType::defaultLateMoveFullMoves;
+    args >> reduction >> fullMoves;
+    if (reduction > 0 && fullMoves > 0)
+    {
+        searchSolver->setLateMoveReductions(reduction, fullMoves);
+        std::cout << "Late move reductions enabled with reduction " << reduction << " after "
+            << fullMoves << " moves" << std::endl;
     }
 }
 
@@ -182,9 +253,22 @@ void setSolver(const string &name, std::istream &args)
         int timeout = 100000, startDepth = 9, depthStep = 1, maxDepth = 9;
         args >> startDepth >> maxDepth >> timeout >> depthStep;
         if (solver) delete solver;
-        solver = new MainSolver(timeout, startDepth, depthStep, maxDepth);
+        MainSolver *mainSolver = new MainSolver(timeout, startDepth, depthStep, maxDepth);
+        solver = mainSolver;
         std::cout << "Set solver to MainSolver with timeout " << timeout << "ms, start depth "
             << startDepth << ", depth step " << depthStep << " and max depth " << maxDepth << std::endl;
+        setLateMoveReductions(mainSolver, args);
+    }
+    else if (name == "mw")
+    {
+        int timeout = 100000, startDepth = 9, depthStep = 1, maxDepth = 9;
+        args >> startDepth >> maxDepth >> timeout >> depthStep;
+        if (solver) delete solver;
+        MainWindowSolver *mainSolver = new MainWindowSolver(timeout, startDepth, depthStep, maxDepth);
+        solver = mainSolver;
+        std::cout << "Set solver to MainWindowSolver with timeout " << timeout << "ms, start depth "
+            << startDepth << ", depth step " << depthStep << " and max depth " << maxDepth << std::endl;
+        setLateMoveReductions(mainSolver, args);
     }
     else if (name == "am")
     {
@@ -194,14 +278,39 @@ void setSolver(const string &name, std::istream &args)
         solver = new AutomarkedSolver(maxDepth, prune);
         std::cout << "Set solver to AutomarkedSolver with maxDepth=" << maxDepth << " and pruning " << (prune ? "enabled" : "disabled") << std::endl;
     }
+    else if (name == "mc")
+    {
+        int timeout = 1000, threads = 1, maxNodes = MonteCarloSolver::defaultMaxNodes;
+        double exploration = MonteCarloSolver::defaultExploration;
+        args >> timeout >> threads >> exploration >> maxNodes;
+        if (timeout <= 0 || threads <= 0 || maxNodes <= Board::width)
+        {
+            std::cout << "Invalid arguments: [timeout] [threads] [exploration] [max nodes]" << std::endl;
+            return;
+        }
+        if (solver) delete solver;
+        MonteCarloSolver *monteCarloSolver = new MonteCarloSolver(timeout, threads, maxNodes);
+        monteCarloSolver->setExploration(exploration);
+        solver = monteCarloSolver;
+        std::cout << "Set solver to MonteCarloSolver with timeout " << timeout << "ms, " << threads
+            << " thread(s), exploration " << exploration << " and " << maxNodes << " nodes" << std::endl;
+    }
     else if (name == "t")
     {
-        int timeout = 100000, startDepth = 9, depthStep = 1, maxDepth = 9;
-        args >> startDepth >> maxDepth >> timeout >> depthStep;
+        // A null move reduction of 0 disables null move pruning
+        int timeout = 100000, startDepth = 9, depthStep = 1, maxDepth = 9, nullMoveReduction = 0;
+        args >> startDepth >> maxDepth >> timeout >> depthStep >> nullMoveReduction;
         if (solver) delete solver;
-        solver = new TournamentSolver(timeout, startDepth, depthStep, maxDepth);
+        TournamentSolver *tournamentSolver = new TournamentSolver(timeout, startDepth, depthStep, maxDepth);
+        tournamentSolver->setNullMovePruning(nullMoveReduction > 0, std::max(nullMoveReduction, 0));
+        solver = tournamentSolver;
         std::cout << "Set solver to TournamentSolver with timeout " << timeout << "ms, start depth "
             << startDepth << ", depth step " << depthStep << " and max depth " << maxDepth << std::endl;
+        if (nullMoveReduction > 0)
+        {
+            std::cout << "Null move pruning enabled with reduction " << nullMoveReduction << std::endl;
+        }
+        setLateMoveReductions(tournamentSolver, args);
     }
     else
     {
@@ -238,11 +347,79 @@ void solveMove(bool play)
     }
 }
 
-void printSolverStatistics()
+void analyseMoves()
+{
+    MainSolver *mainSolver = dynamic_cast<MainSolver *>(solver);
+    if (!mainSolver)
+    {
+        std::cout << "Analysis requires the MainSolver" << std::endl;
+        return;
+    }
+
+    MainSolver::AnalysisArray analysis;
+    std::clock_t clocks = std::clock();
+    int move = mainSolver->analyse(board, analysis);
+    clocks = std::clock() - clocks;
+
+    for (int column = 0; column < Board::width; ++column)
+    {
+        const MainSolver::MoveAnalysis &result = analysis[column];
+        std::cout << "Column " << column << ": ";
+        switch (result.type)
+        {
+        case evaluation_none:
+            std::cout << "unplayable" << std::endl;
+            continue;
+        case evaluation_belowAlpha:
+            std::cout << "<= ";
+            break;
+        case evaluation_aboveBeta:
+            std::cout << ">= ";
+            break;
+        default:
+            break;
+        }
+        std::cout << result.value << " (height " << result.height << ")" << std::endl;
+    }
+
+    if (move != -1)
+    {
+        std::cout << "Best move: " << move << std::endl;
+    }
+    else
+    {
+        std::cout << "Unable to analyse" << std::endl;
+    }
+    std::cout << "Time taken: " << ((clocks * 1000) / CLOCKS_PER_SEC) << " ms" << std::endl;
+}
+
+void printSolverStatistics(std::istream &args)
 {
     if (solver)
     {
-        solver->printStatistics(std::cout);
+        // Options select totals over every solve and JSON output
+        bool total = false, json = false;
+        string option;
+        while (args >> option)
+        {
+            total = total || option == "total";
+            json = json || option == "json";
+        }
+
+        const SearchStatistics &stats = total ? solver->totalStatistics() : solver->statistics();
+        if (json)
+        {
+            stats.printJson(std::cout);
+        }
+        else if (total)
+        {
+            stats.print(std::cout);
+        }
+        else
+        {
+            // The solver may add its own details for the last solve
+            solver->printStatistics(std::cout);
+        }
     }
     else
     {
@@ -327,6 +504,16 @@ int main(int argc, char **argv)
             iss >> pieces;
             random(pieces);
         }
+        else if (command == "playouts")
+        {
+            int games = 0;
+            iss >> games;
+            runPlayouts(games);
+        }
+        else if (command == "perft")
+        {
+            runPerft(iss);
+        }
         else if (command == "solver")
         {
             string solverName;
@@ -337,9 +524,13 @@ int main(int argc, char **argv)
         {
             solveMove(command == "auto");
         }
+        else if (command == "analyse" || command == "analyze")
+        {
+            analyseMoves();
+        }
         else if (command == "stats")
         {
-            printSolverStatistics();
+            printSolverStatistics(iss);
         }
         else if (command == "hash")
         {
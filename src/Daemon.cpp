@@ -0,0 +1,414 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <cstdlib>
+#include <sys/socket.h>
+
+#include "board.h"
+#include "mainsolver.h"
+#include "tournamentsolver.h"
+#include "linesocket.h"
+
+// Daemon serving solve requests from local clients over a Unix domain socket, one command per line:
+// - solve <description> <r|y> <ms>: find a move for the player, replying "move <column> <latency ms>" or
+//   "move pass <latency ms>". The time is the deadline from when the request arrives, so time spent waiting
+//   for a worker is taken from the search. Requests are rejected with "busy" when the queue is full, and
+//   answered with "expired" if their deadline passes before a worker takes them.
+// - stats: reply "stats queued <n> active <n> completed <n> rejected <n> expired <n> p50 <ms> p90 <ms> p99 <ms>",
+//   with percentiles of the latency of recent requests.
+// - shutdown: reply "ok", stop accepting connections, and exit once the queued requests are answered.
+// Invalid commands, and positions where the game is already over, are answered with "error <message>".
+//
+// Every worker has its own solver, and the solvers share one transposition table. Table values depend only on
+// the position, so results from one game are valid in every other.
+
+using namespace ConnectFour;
+using std::string;
+
+typedef std::chrono::steady_clock Clock;
+
+/// @brief Options given on the command line.
+struct Options
+{
+    string socketPath;
+    string rules; // standard or tournament
+    int workers;
+    int maxQueued; // Requests waiting for a worker before more are rejected
+    int tableSize; // Entries in the shared transposition table
+};
+
+/// @brief A solve request waiting for a worker.
+struct Request
+{
+    Board board;
+    Clock::time_point arrival;
+    Clock::time_point deadline;
+    std::promise<string> reply;
+};
+
+/// @class RequestQueue
+/// @brief Bounded queue of requests shared by the connections and the workers.
+class RequestQueue
+{
+public:
+    explicit RequestQueue(int maxQueued) : maxQueued(maxQueued), closed(false) {}
+
+    /// @brief Add a request unless the queue is full or closed.
+    /// @return Whether the request was added.
+    bool push(const std::shared_ptr<Request> &request)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed || static_cast<int>(requests.size()) >= maxQueued) return false;
+        requests.push_back(request);
+        available.notify_one();
+        return true;
+    }
+
+    /// @brief Wait for the next request.
+    /// @return The request, or null once the queue is closed and empty.
+    std::shared_ptr<Request> pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return closed || !requests.empty(); });
+        if (requests.empty()) return std::shared_ptr<Request>();
+        std::shared_ptr<Request> request = requests.front();
+        requests.pop_front();
+        return request;
+    }
+
+    /// @brief Stop accepting requests. Those already queued are still popped.
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        available.notify_all();
+    }
+
+    int size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(requests.size());
+    }
+
+private:
+    const int maxQueued;
+    bool closed;
+    std::deque<std::shared_ptr<Request> > requests;
+    std::mutex mutex;
+    std::condition_variable available;
+};
+
+/// @class ServerStatistics
+/// @brief Counts of requests by outcome, and the latencies of the most recent completed requests.
+class ServerStatistics
+{
+public:
+    ServerStatistics() : active(0), completed(0), rejected(0), expired(0), next(0) {}
+
+    std::atomic<int> active;
+    std::atomic<long long> completed;
+    std::atomic<long long> rejected;
+    std::atomic<long long> expired;
+
+    void addLatency(double milliseconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (latencies.size() < maxLatencies)
+        {
+            latencies.push_back(milliseconds);
+        }
+        else
+        {
+            latencies[next] = milliseconds;
+            next = (next + 1) % maxLatencies;
+        }
+    }
+
+    /// @brief Get the latency at a percentile of the recent requests using the nearest rank, or 0 if there are none.
+    double latencyPercentile(double p)
+    {
+        std::vector<double> sorted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sorted = latencies;
+        }
+        if (sorted.empty()) return 0;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = std::max<size_t>(static_cast<size_t>(p / 100 * sorted.size() + 0.5), 1);
+        return sorted[std::min(rank, sorted.size()) - 1];
+    }
+
+private:
+    static const size_t maxLatencies = 1024;
+    std::vector<double> latencies;
+    size_t next; // Index of the oldest latency once the buffer is full
+    std::mutex mutex;
+};
+
+static double millisecondsBetween(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// @class Server
+/// @brief Accepts connections and answers their requests with a pool of workers.
+template <class SolverType>
+class Server
+{
+public:
+    explicit Server(const Options &options) :
+        options(options),
+        table(options.tableSize),
+        queue(options.maxQueued),
+        listenFd(-1),
+        stopping(false)
+    {
+    }
+
+    /// @brief Serve requests until a shutdown command.
+    /// @return Whether the socket could be listened on.
+    bool run()
+    {
+        listenFd = LineSocket::listenOn(options.socketPath, 64);
+        if (listenFd == -1) return false;
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < options.workers; ++i)
+        {
+            workers.push_back(std::thread(&Server::work, this));
+        }
+        std::cerr << "Listening on " << options.socketPath << " with " << options.workers << " workers" << std::endl;
+
+        while (!stopping)
+        {
+            int fd = accept(listenFd, 0, 0);
+            if (fd == -1) continue;
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            connections.insert(fd);
+            std::thread(&Server::serveConnection, this, fd).detach();
+        }
+
+        close(listenFd);
+        unlink(options.socketPath.c_str());
+
+        // Answer the queued requests, then end the connections waiting for more
+        queue.close();
+        for (std::vector<std::thread>::iterator worker = workers.begin(); worker != workers.end(); ++worker)
+        {
+            worker->join();
+        }
+        std::unique_lock<std::mutex> lock(connectionMutex);
+        for (std::set<int>::const_iterator fd = connections.begin(); fd != connections.end(); ++fd)
+        {
+            shutdown(*fd, SHUT_RDWR);
+        }
+        connectionEnded.wait(lock, [this] { return connections.empty(); });
+        return true;
+    }
+
+private:
+    const Options options;
+    // Entries shared by the solver of every worker
+    SharedTranspositionTable table;
+    RequestQueue queue;
+    ServerStatistics stats;
+    int listenFd;
+    std::atomic<bool> stopping;
+
+    // Sockets of the connections being served
+    std::set<int> connections;
+    std::mutex connectionMutex;
+    std::condition_variable connectionEnded;
+
+    void work()
+    {
+        SolverType solver(1000, 1, 1, -1);
+        solver.transpositionTable().share(table);
+        solver.setKeepTable(true);
+
+        std::shared_ptr<Request> request;
+        while ((request = queue.pop()))
+        {
+            const Clock::time_point start = Clock::now();
+            const int remaining = static_cast<int>(millisecondsBetween(start, request->deadline));
+            if (remaining < 1)
+            {
+                ++stats.expired;
+                request->reply.set_value("expired");
+                continue;
+            }
+
+            ++stats.active;
+            solver.setMaxSolveTime(remaining);
+            int move = SolverType::moveToPlay(request->board, solver.solve(request->board));
+            --stats.active;
+
+            const double latency = millisecondsBetween(request->arrival, Clock::now());
+            stats.addLatency(latency);
+            ++stats.completed;
+
+            std::ostringstream reply;
+            reply << "move ";
+            if (move == Board::width)
+            {
+                reply << "pass";
+            }
+            else
+            {
+                reply << move;
+            }
+            reply << " " << latency;
+            request->reply.set_value(reply.str());
+        }
+    }
+
+    void serveConnection(int fd)
+    {
+        {
+            LineSocket socket(fd);
+            string line;
+            while (socket.readLine(line))
+            {
+                if (!socket.writeLine(handle(line))) break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        connections.erase(fd);
+        connectionEnded.notify_all();
+    }
+
+    /// @brief Get the reply to a command line, waiting for a worker to solve it if necessary.
+    string handle(const string &line)
+    {
+        std::istringstream args(line);
+        string command;
+        args >> command;
+        if (command == "solve")
+        {
+            const Clock::time_point arrival = Clock::now();
+            string description, player;
+            int time = 0;
+            if (!(args >> description >> player >> time) || (player != "r" && player != "y") || time <= 0)
+            {
+                return "error expected solve <description> <r|y> <ms>";
+            }
+
+            std::shared_ptr<Request> request = std::make_shared<Request>();
+            try
+            {
+                request->board.setFromDescription(description);
+            }
+            catch (std::invalid_argument &e)
+            {
+                return string("error invalid position: ") + e.what();
+            }
+            if (player == "y")
+            {
+                request->board.swap();
+            }
+            if (request->board.isGameOver())
+            {
+                return "error game is over";
+            }
+            request->arrival = arrival;
+            request->deadline = arrival + std::chrono::milliseconds(time);
+
+            std::future<string> reply = request->reply.get_future();
+            if (!queue.push(request))
+            {
+                ++stats.rejected;
+                return "busy";
+            }
+            return reply.get();
+        }
+        else if (command == "stats")
+        {
+            std::ostringstream reply;
+            reply << "stats queued " << queue.size() << " active " << stats.active << " completed " << stats.completed
+                << " rejected " << stats.rejected << " expired " << stats.expired
+                << " p50 " << stats.latencyPercentile(50) << " p90 " << stats.latencyPercentile(90)
+                << " p99 " << stats.latencyPercentile(99);
+            return reply.str();
+        }
+        else if (command == "shutdown")
+        {
+            stopping = true;
+            // Wake the accept call
+            shutdown(listenFd, SHUT_RDWR);
+            return "ok";
+        }
+        return "error unknown command " + command;
+    }
+};
+
+static void printUsage()
+{
+    std::cerr << "Usage: Daemon [options]" << std::endl
+        << "  -s <path>     Socket path (default /tmp/connect4ai.sock)" << std::endl
+        << "  -r <rules>    Rules of the game: standard or tournament (default standard)" << std::endl
+        << "  -w <workers>  Number of worker threads (default the number of hardware threads)" << std::endl
+        << "  -q <count>    Requests that may wait for a worker before more are rejected (default 4 per worker)" << std::endl
+        << "  -m <entries>  Entries in the shared transposition table, a multiple of 2 (default 2097152)" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    options.socketPath = "/tmp/connect4ai.sock";
+    options.rules = "standard";
+    options.workers = std::max<int>(std::thread::hardware_concurrency(), 1);
+    options.maxQueued = -1;
+    options.tableSize = 2097152;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "-s" && hasValue) options.socketPath = argv[++i];
+        else if (arg == "-r" && hasValue) options.rules = argv[++i];
+        else if (arg == "-w" && hasValue) options.workers = std::atoi(argv[++i]);
+        else if (arg == "-q" && hasValue) options.maxQueued = std::atoi(argv[++i]);
+        else if (arg == "-m" && hasValue) options.tableSize = std::atoi(argv[++i]);
+        else
+        {
+            printUsage();
+            return -1;
+        }
+    }
+    if (options.maxQueued == -1) options.maxQueued = 4 * options.workers;
+    if (options.workers < 1 || options.maxQueued < 0 || options.tableSize < 2 || options.tableSize % 2 != 0
+        || (options.rules != "standard" && options.rules != "tournament"))
+    {
+        printUsage();
+        return -1;
+    }
+
+    bool listened;
+    if (options.rules == "tournament")
+    {
+        listened = Server<SharedTournamentSolver>(options).run();
+    }
+    else
+    {
+        listened = Server<SharedMainSolver>(options).run();
+    }
+    if (!listened)
+    {
+        std::cerr << "Unable to listen on " << options.socketPath << std::endl;
+        return -1;
+    }
+    return 0;
+}
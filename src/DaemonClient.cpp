@@ -0,0 +1,181 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cstdlib>
+
+#include "linesocket.h"
+
+// Client for the Daemon. Sends the command given on the command line, or each line read from stdin, and
+// writes the replies. With -l it instead replays positions from a file over several connections at once to
+// load test the daemon, then writes the counts of each reply and the daemon's statistics.
+
+using namespace ConnectFour;
+using std::string;
+
+/// @brief Options given on the command line.
+struct Options
+{
+    string socketPath;
+    string loadFile; // Positions to load test with, or empty to send commands
+    int connections;
+    int requests; // Requests sent by each connection
+    int time; // Time for each solve request in milliseconds
+};
+
+static void printUsage()
+{
+    std::cerr << "Usage: DaemonClient [options] [command...]" << std::endl
+        << "  -s <path>         Socket path (default /tmp/connect4ai.sock)" << std::endl
+        << "  -l <file>         Load test with the positions in a file, with a description first on each line" << std::endl
+        << "  -c <connections>  Connections sending requests at once in a load test (default 8)" << std::endl
+        << "  -n <requests>     Requests sent by each connection in a load test (default 16)" << std::endl
+        << "  -t <ms>           Time for each solve in a load test (default 100)" << std::endl;
+}
+
+/// @brief Send a command on a new connection and get the reply.
+/// @return Whether there was a reply.
+static bool sendCommand(const string &socketPath, const string &command, string &reply)
+{
+    int fd = LineSocket::connectTo(socketPath);
+    if (fd == -1) return false;
+    LineSocket socket(fd);
+    return socket.writeLine(command) && socket.readLine(reply);
+}
+
+static std::vector<string> readDescriptions(const string &path)
+{
+    std::ifstream file(path.c_str());
+    std::vector<string> descriptions;
+    string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        string description;
+        if (iss >> description) descriptions.push_back(description);
+    }
+    return descriptions;
+}
+
+static int loadTest(const Options &options)
+{
+    std::vector<string> descriptions = readDescriptions(options.loadFile);
+    if (descriptions.empty())
+    {
+        std::cerr << "No positions in " << options.loadFile << std::endl;
+        return -1;
+    }
+
+    std::map<string, int> replyCounts; // Counts by the first word of the reply
+    std::mutex countMutex;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < options.connections; ++c)
+    {
+        threads.push_back(std::thread([&, c]
+        {
+            int fd = LineSocket::connectTo(options.socketPath);
+            if (fd == -1)
+            {
+                std::lock_guard<std::mutex> lock(countMutex);
+                ++replyCounts["unconnected"];
+                return;
+            }
+            LineSocket socket(fd);
+            for (int i = 0; i < options.requests; ++i)
+            {
+                std::ostringstream request;
+                request << "solve " << descriptions[(c * options.requests + i) % descriptions.size()] << " r " << options.time;
+                string reply;
+                if (!socket.writeLine(request.str()) || !socket.readLine(reply)) reply = "disconnected";
+                std::lock_guard<std::mutex> lock(countMutex);
+                ++replyCounts[reply.substr(0, reply.find(' '))];
+            }
+        }));
+    }
+    for (std::vector<std::thread>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+    {
+        thread->join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int total = options.connections * options.requests;
+    std::cout << total << " requests in " << seconds << " s (" << total / seconds << " requests/s)" << std::endl;
+    for (std::map<string, int>::const_iterator count = replyCounts.begin(); count != replyCounts.end(); ++count)
+    {
+        std::cout << count->first << ": " << count->second << std::endl;
+    }
+
+    string stats;
+    if (sendCommand(options.socketPath, "stats", stats))
+    {
+        std::cout << stats << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    options.socketPath = "/tmp/connect4ai.sock";
+    options.connections = 8;
+    options.requests = 16;
+    options.time = 100;
+
+    string command;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (!command.empty()) command += " " + arg;
+        else if (arg == "-s" && hasValue) options.socketPath = argv[++i];
+        else if (arg == "-l" && hasValue) options.loadFile = argv[++i];
+        else if (arg == "-c" && hasValue) options.connections = std::atoi(argv[++i]);
+        else if (arg == "-n" && hasValue) options.requests = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue) options.time = std::atoi(argv[++i]);
+        else if (arg[0] == '-')
+        {
+            printUsage();
+            return -1;
+        }
+        else command = arg;
+    }
+    if (options.connections < 1 || options.requests < 1 || options.time < 1)
+    {
+        printUsage();
+        return -1;
+    }
+
+    if (!options.loadFile.empty())
+    {
+        return loadTest(options);
+    }
+
+    int fd = LineSocket::connectTo(options.socketPath);
+    if (fd == -1)
+    {
+        std::cerr << "Unable to connect to " << options.socketPath << std::endl;
+        return -1;
+    }
+    LineSocket socket(fd);
+    string line, reply;
+    if (!command.empty())
+    {
+        if (!socket.writeLine(command) || !socket.readLine(reply)) return -1;
+        std::cout << reply << std::endl;
+        return 0;
+    }
+    while (std::getline(std::cin, line))
+    {
+        if (!socket.writeLine(line) || !socket.readLine(reply)) return -1;
+        std::cout << reply << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,352 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "board.h"
+#include "searchpolicies.h"
+#include "playouts.h"
+
+using namespace ConnectFour;
+using std::string;
+
+/// @brief Prevent the compiler from optimising away the computation of a value.
+template <class T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char *>(&value);
+#endif
+}
+
+/// @class PerfCounters
+/// @brief Hardware counters for cycles, instructions and branch misses, read with perf_event_open.
+///        The counters are unavailable on other platforms or if the kernel doesn't permit them.
+class PerfCounters
+{
+public:
+    static const int counterCount = 3;
+
+    /// @param enable Whether to open the counters, otherwise they are left unavailable.
+    explicit PerfCounters(bool enable) : available(false)
+    {
+#ifdef __linux__
+        const unsigned long long configs[counterCount] =
+            { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES };
+        available = enable;
+        for (int i = 0; i < counterCount; ++i)
+        {
+            descriptors[i] = -1;
+            if (!enable) continue;
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            descriptors[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            available = available && descriptors[i] != -1;
+        }
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int i = 0; i < counterCount; ++i)
+        {
+            if (descriptors[i] != -1) close(descriptors[i]);
+        }
+#endif
+    }
+
+    bool isAvailable() const { return available; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (!available) return;
+        for (int i = 0; i < counterCount; ++i)
+        {
+            ioctl(descriptors[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// @brief Stop counting and read the counts of cycles, instructions and branch misses.
+    void stop(long long counts[counterCount])
+    {
+        for (int i = 0; i < counterCount; ++i)
+        {
+            counts[i] = 0;
+#ifdef __linux__
+            if (!available) continue;
+            ioctl(descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(descriptors[i], &counts[i], sizeof(counts[i])) != sizeof(counts[i]))
+            {
+                counts[i] = 0;
+            }
+#endif
+        }
+    }
+
+private:
+    bool available;
+#ifdef __linux__
+    int descriptors[counterCount];
+#endif
+};
+
+/// @brief Pre-generated inputs for the primitives.
+struct Inputs
+{
+    std::vector<Board> boards;
+    std::vector<int> columns; // A playable column for each board
+    std::vector<string> descriptions;
+};
+
+/// @brief Measurement of a single primitive.
+struct Measurement
+{
+    string name;
+    double nanoseconds; // Per operation
+    long long counts[PerfCounters::counterCount]; // Per operation, scaled by countScale
+};
+
+// Counter values are reported per 100 operations to keep some precision
+static const int countScale = 100;
+
+/// @brief Generate random positions by random play, stopping each game before a win or full board.
+static Inputs generateInputs(int count)
+{
+    Inputs inputs;
+    while (static_cast<int>(inputs.boards.size()) < count)
+    {
+        Board board;
+        int pieces = std::rand() % (Board::width*Board::height - 1);
+        for (int i = 0; i < pieces; ++i)
+        {
+            int column = std::rand() % Board::width;
+            if (!board.canPlay(column)) continue;
+            Board next(board);
+            next.play(column);
+            if (next.isWin()) break;
+            board = next;
+            board.swap();
+        }
+
+        int column = std::rand() % Board::width;
+        while (!board.canPlay(column))
+        {
+            column = (column + 1) % Board::width;
+        }
+        inputs.boards.push_back(board);
+        inputs.columns.push_back(column);
+        inputs.descriptions.push_back(board.getDescription());
+    }
+    return inputs;
+}
+
+/// @brief Time a primitive, running it over every input until the target time is reached.
+template <class Operation>
+static Measurement measure(const string &name, const Inputs &inputs, Operation operation, double targetMs, PerfCounters &counters)
+{
+    const size_t n = inputs.boards.size();
+
+    // Warm up caches and branch predictors
+    for (size_t i = 0; i < n; ++i)
+    {
+        operation(inputs, i);
+    }
+
+    long long operations = 0;
+    long long counts[PerfCounters::counterCount] = {};
+    double elapsed = 0;
+    while (elapsed < targetMs)
+    {
+        long long passCounts[PerfCounters::counterCount];
+        counters.start();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+        {
+            operation(inputs, i);
+        }
+        elapsed += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        counters.stop(passCounts);
+        for (int i = 0; i < PerfCounters::counterCount; ++i)
+        {
+            counts[i] += passCounts[i];
+        }
+        operations += n;
+    }
+
+    Measurement result;
+    result.name = name;
+    result.nanoseconds = elapsed * 1e6 / operations;
+    for (int i = 0; i < PerfCounters::counterCount; ++i)
+    {
+        result.counts[i] = counts[i] * countScale / operations;
+    }
+    return result;
+}
+
+// Operations for each primitive. Boards are copied where the primitive modifies them.
+static void opCopy(const Inputs &in, size_t i) { Board b(in.boards[i]); doNotOptimize(b); }
+static void opPlay(const Inputs &in, size_t i) { Board b(in.boards[i]); b.play(in.columns[i]); doNotOptimize(b); }
+static void opIsWin(const Inputs &in, size_t i) { doNotOptimize(in.boards[i].isWin()); }
+static void opCanPlay(const Inputs &in, size_t i) { doNotOptimize(in.boards[i].canPlay(in.columns[i])); }
+static void opGetThreats(const Inputs &in, size_t i) { doNotOptimize(in.boards[i].getThreats(false)); }
+static void opGetThreatInfo(const Inputs &in, size_t i) { doNotOptimize(in.boards[i].getThreatInfo()); }
+static void opCountConnections(const Inputs &in, size_t i) { doNotOptimize(in.boards[i].countConnections()); }
+static void opSwap(const Inputs &in, size_t i) { Board b(in.boards[i]); b.swap(); doNotOptimize(b); }
+static void opSetFromDescription(const Inputs &in, size_t i) { Board b; b.setFromDescription(in.descriptions[i]); doNotOptimize(b); }
+
+// Leaf scoring by each evaluation. The window evaluation is updated for a move and back as a search would,
+// with counts from the empty board as only the cost of the update matters.
+static WindowEvaluation windowEvaluation;
+static void opThreatScore(const Inputs &in, size_t i) { doNotOptimize(ThreatEvaluation::score(in.boards[i])); }
+static void opWindowScore(const Inputs &in, size_t i)
+{
+    windowEvaluation.play(in.boards[i], in.columns[i]);
+    doNotOptimize(windowEvaluation.score(in.boards[i]));
+    windowEvaluation.undo(in.boards[i], in.columns[i]);
+}
+
+// Random games played to the end, one at a time on a Board retrying full columns, and in lockstep where each
+// operation plays a game from the board in every lane
+static void opRandomPlayout(const Inputs &in, size_t i)
+{
+    Board b(in.boards[i]);
+    while (b.totalCount() < Board::width*Board::height)
+    {
+        int column = std::rand() % Board::width;
+        if (!b.canPlay(column)) continue;
+        b.play(column);
+        if (b.isWin()) break;
+        b.swap();
+    }
+    doNotOptimize(b);
+}
+static LockstepPlayouts lockstepPlayouts;
+static void opLockstepPlayouts(const Inputs &in, size_t i)
+{
+    doNotOptimize(lockstepPlayouts.play(in.boards[i], LockstepPlayouts::lanes).wins);
+}
+
+static void printUsage()
+{
+    std::cerr << "Usage: MicroBench [options]" << std::endl
+        << "  -n <positions>  Number of random positions to generate (default 65536)" << std::endl
+        << "  -t <ms>         Target time for each primitive (default 200)" << std::endl
+        << "  -c              Read hardware counters with perf_event_open" << std::endl
+        << "  -f <format>     Output format: text or json (default text)" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int positions = 65536;
+    double targetMs = 200;
+    bool useCounters = false;
+    string format = "text";
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "-n" && hasValue) positions = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue) targetMs = std::atof(argv[++i]);
+        else if (arg == "-c") useCounters = true;
+        else if (arg == "-f" && hasValue) format = argv[++i];
+        else
+        {
+            printUsage();
+            return -1;
+        }
+    }
+    if (positions < 1 || targetMs <= 0)
+    {
+        printUsage();
+        return -1;
+    }
+
+    // Fixed seed so every run measures the same positions
+    std::srand(1);
+    Inputs inputs = generateInputs(positions);
+
+    PerfCounters counters(useCounters);
+    if (useCounters && !counters.isAvailable())
+    {
+        std::cerr << "Hardware counters are unavailable" << std::endl;
+        useCounters = false;
+    }
+
+    windowEvaluation.reset(Board());
+
+    std::vector<Measurement> results;
+    results.push_back(measure("copy", inputs, opCopy, targetMs, counters));
+    results.push_back(measure("play", inputs, opPlay, targetMs, counters));
+    results.push_back(measure("isWin", inputs, opIsWin, targetMs, counters));
+    results.push_back(measure("canPlay", inputs, opCanPlay, targetMs, counters));
+    results.push_back(measure("getThreats", inputs, opGetThreats, targetMs, counters));
+    results.push_back(measure("getThreatInfo", inputs, opGetThreatInfo, targetMs, counters));
+    results.push_back(measure("countConnections", inputs, opCountConnections, targetMs, counters));
+    results.push_back(measure("swap", inputs, opSwap, targetMs, counters));
+    results.push_back(measure("setFromDescription", inputs, opSetFromDescription, targetMs, counters));
+    results.push_back(measure("threatScore", inputs, opThreatScore, targetMs, counters));
+    results.push_back(measure("windowScore", inputs, opWindowScore, targetMs, counters));
+    results.push_back(measure("randomPlayout", inputs, opRandomPlayout, targetMs, counters));
+
+    // Report the lockstep playouts per game, to compare with a single random playout
+    Measurement lockstep = measure("lockstepPlayout", inputs, opLockstepPlayouts, targetMs, counters);
+    lockstep.nanoseconds /= LockstepPlayouts::lanes;
+    for (int i = 0; i < PerfCounters::counterCount; ++i)
+    {
+        lockstep.counts[i] /= LockstepPlayouts::lanes;
+    }
+    results.push_back(lockstep);
+
+    if (format == "json") std::cout << "{\"results\":[";
+    for (std::vector<Measurement>::const_iterator i = results.begin(); i != results.end(); ++i)
+    {
+        double opsPerSecond = i->nanoseconds > 0 ? 1e9 / i->nanoseconds : 0;
+        if (format == "json")
+        {
+            std::cout << (i == results.begin() ? "" : ",")
+                << "{\"primitive\":\"" << i->name << "\",\"nsPerOp\":" << i->nanoseconds
+                << ",\"opsPerSecond\":" << static_cast<long long>(opsPerSecond);
+            if (useCounters)
+            {
+                std::cout << ",\"cyclesPerOp\":" << i->counts[0] / double(countScale)
+                    << ",\"instructionsPerOp\":" << i->counts[1] / double(countScale)
+                    << ",\"branchMissesPerOp\":" << i->counts[2] / double(countScale);
+            }
+            std::cout << "}";
+        }
+        else
+        {
+            std::cout << i->name << ": " << i->nanoseconds << " ns/op, " << static_cast<long long>(opsPerSecond) << " ops/s";
+            if (useCounters)
+            {
+                std::cout << ", " << i->counts[0] / double(countScale) << " cycles, "
+                    << i->counts[1] / double(countScale) << " instructions, "
+                    << i->counts[2] / double(countScale) << " branch misses";
+            }
+            std::cout << std::endl;
+        }
+    }
+    if (format == "json") std::cout << "]}" << std::endl;
+}
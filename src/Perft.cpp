@@ -0,0 +1,108 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "board.h"
+#include "perft.h"
+
+using namespace ConnectFour;
+using std::string;
+
+static void printUsage()
+{
+    std::cerr << "Usage: Perft <depth> [options]" << std::endl
+        << "  -b <board>    Board description to start from (default empty board)" << std::endl
+        << "  -y            The current player is yellow" << std::endl
+        << "  -u            Count only distinct positions, using the board hash" << std::endl
+        << "  -j <threads>  Number of threads to split root moves between (default 1)" << std::endl
+        << "  -a            Count every depth up to the given depth" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return -1;
+    }
+
+    int depth = std::atoi(argv[1]);
+    string description;
+    bool yellow = false, deduplicate = false, allDepths = false;
+    int threads = 1;
+    for (int i = 2; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "-b" && hasValue) description = argv[++i];
+        else if (arg == "-y") yellow = true;
+        else if (arg == "-u") deduplicate = true;
+        else if (arg == "-j" && hasValue) threads = std::atoi(argv[++i]);
+        else if (arg == "-a") allDepths = true;
+        else
+        {
+            printUsage();
+            return -1;
+        }
+    }
+    if (depth < 0 || threads < 1)
+    {
+        printUsage();
+        return -1;
+    }
+
+    Board board;
+    try
+    {
+        if (!description.empty())
+        {
+            board.setFromDescription(description);
+        }
+    }
+    catch (std::invalid_argument &e)
+    {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return -1;
+    }
+    if (yellow)
+    {
+        board.swap();
+    }
+
+    bool allMatch = true;
+    for (int d = allDepths ? 0 : depth; d <= depth; ++d)
+    {
+        PerftResult result = perft(board, d, deduplicate, threads);
+        std::cout << "Depth " << d << ": " << result.leaves << " leaves, " << result.wins << " wins, "
+            << result.milliseconds << " ms, "
+            << static_cast<long long>(result.milliseconds > 0 ? result.leaves * 1000.0 / result.milliseconds : 0)
+            << " positions/s";
+
+        // Counts are known for the empty board
+        long long known = description.empty() ? knownPerft(d, deduplicate) : -1;
+        if (known != -1)
+        {
+            if (known == result.leaves)
+            {
+                std::cout << " (matches known count)";
+            }
+            else
+            {
+                std::cout << " (expected " << known << ")";
+                allMatch = false;
+            }
+        }
+        std::cout << std::endl;
+
+        if (d == depth && d > 0)
+        {
+            for (int column = 0; column < Board::width; ++column)
+            {
+                std::cout << "  " << column << ": " << result.rootLeaves[column] << std::endl;
+            }
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
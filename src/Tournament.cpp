@@ -2,20 +2,226 @@
 #include <cassert>
 #include <stdexcept>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
 
 #include "board.h"
 #include "tournamentsolver.h"
 
 using namespace ConnectFour;
 
+// Time in milliseconds for each move, within the tournament's limit of one second
+static const int moveTime = 970;
+
+/// @brief Write the statistics for the last solve to stderr in the given format, if any.
+static void printStatistics(const TournamentSolver &solver, const std::string &format)
+{
+    // Statistics are written to stderr so that the move output is unchanged
+    if (format == "json")
+    {
+        solver.statistics().printJson(std::cerr);
+    }
+    else if (format == "stats")
+    {
+        solver.printStatistics(std::cerr);
+    }
+}
+
+/// @brief Read the optional arguments from the given index: the statistics format (json or stats), and
+///        -t <file> to keep the transposition table in a file between runs.
+/// @return Whether every argument was valid.
+static bool readOptions(int argc, char **argv, int first, std::string &statisticsFormat, std::string &tableFile)
+{
+    for (int i = first; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "-t" && i + 1 < argc) tableFile = argv[++i];
+        else if (arg == "json" || arg == "stats") statisticsFormat = arg;
+        else return false;
+    }
+    return true;
+}
+
+/// @brief Map the solver's table to a file, if one is given. The solve runs without it if it can't be mapped.
+static void mapTableFile(TournamentSolver &solver, const std::string &tableFile)
+{
+    if (!tableFile.empty() && !solver.mapTableFile(tableFile))
+    {
+        std::cerr << "Unable to map table file " << tableFile << ", it may be in use by another process" << std::endl;
+    }
+}
+
+/// @class Engine
+/// @brief Long running engine that reads commands from stdin, one per line, and keeps its solver and
+///        transposition table between moves. Commands:
+///        - newgame: forget the results of previous moves.
+///        - position <description> <r|y>: set the board and the player to move.
+///        - go [ms]: start solving the position, taking at most the given time (default moveTime).
+///          The result is written as "bestmove <column>" or "bestmove pass" once the solve finishes.
+///        - stop: finish the current solve as soon as possible.
+///        - isready: write "readyok" once any previous command has been handled.
+///        - quit: stop and exit.
+///        Invalid commands are answered with "error <message>".
+class Engine
+{
+public:
+    Engine(const std::string &statisticsFormat, const std::string &tableFile) :
+        solver(moveTime, 8, 1, -1),
+        statisticsFormat(statisticsFormat)
+    {
+        solver.setKeepTable(true);
+        mapTableFile(solver, tableFile);
+        board.clear();
+    }
+
+    ~Engine()
+    {
+        stop();
+    }
+
+    /// @brief Handle commands until quit or the end of the input.
+    void run(std::istream &in)
+    {
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream args(line);
+            std::string command;
+            if (!(args >> command)) continue;
+
+            if (command == "quit")
+            {
+                break;
+            }
+            else if (command == "newgame")
+            {
+                stop();
+                solver.newGame();
+                board.clear();
+            }
+            else if (command == "position")
+            {
+                stop();
+                setPosition(args);
+            }
+            else if (command == "go")
+            {
+                stop();
+                int time = moveTime;
+                if (!(args >> time)) time = moveTime;
+                if (time <= 0)
+                {
+                    write("error invalid time");
+                    continue;
+                }
+                solver.setMaxSolveTime(time);
+                solver.clearStop();
+                searchThread = std::thread(&Engine::search, this, board);
+            }
+            else if (command == "stop")
+            {
+                stop();
+            }
+            else if (command == "isready")
+            {
+                write("readyok");
+            }
+            else
+            {
+                write("error unknown command " + command);
+            }
+        }
+        stop();
+    }
+
+private:
+    TournamentSolver solver;
+    Board board;
+    const std::string statisticsFormat;
+
+    // Thread running the current solve, if any
+    std::thread searchThread;
+    // Lock for writing to stdout from either thread
+    std::mutex outputMutex;
+
+    void setPosition(std::istream &args)
+    {
+        std::string description, player;
+        if (!(args >> description >> player) || (player != "r" && player != "y"))
+        {
+            write("error expected position <description> <r|y>");
+            return;
+        }
+        try
+        {
+            Board newBoard;
+            newBoard.setFromDescription(description);
+            if (player == "y")
+            {
+                newBoard.swap();
+            }
+            board = newBoard;
+        }
+        catch (std::invalid_argument &e)
+        {
+            write(std::string("error invalid position: ") + e.what());
+        }
+    }
+
+    /// @brief Solve a board and write the result. Runs on the search thread.
+    void search(Board position)
+    {
+        int move = TournamentSolver::moveToPlay(position, solver.solve(position));
+        printStatistics(solver, statisticsFormat);
+        std::ostringstream result;
+        result << "bestmove ";
+        if (move == Board::width)
+        {
+            result << "pass";
+        }
+        else
+        {
+            result << move;
+        }
+        write(result.str());
+    }
+
+    /// @brief Finish the current solve, if any, once it has written its result.
+    void stop()
+    {
+        if (searchThread.joinable())
+        {
+            solver.stop();
+            searchThread.join();
+        }
+    }
+
+    void write(const std::string &line)
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << std::endl;
+    }
+};
+
 int main(int argc, char **argv)
 {
-    if (argc <= 2)
+    bool engineMode = argc > 1 && std::string(argv[1]) == "engine";
+    std::string statisticsFormat, tableFile;
+    if ((!engineMode && argc <= 2) || !readOptions(argc, argv, engineMode ? 2 : 3, statisticsFormat, tableFile))
     {
-        std::cerr << "Expected more arguments" << std::endl;
+        std::cerr << "Expected arguments: <description> <r|y> [json|stats] [-t <table file>], "
+            "or engine [json|stats] [-t <table file>]" << std::endl;
         return -1;
     }
 
+    if (engineMode)
+    {
+        Engine engine(statisticsFormat, tableFile);
+        engine.run(std::cin);
+        return 0;
+    }
+
     bool yellow = argv[2][0] == 'y';
 
     try
@@ -28,18 +234,16 @@ int main(int argc, char **argv)
             board.swap();
         }
 
-        TournamentSolver solver(970, 8, 1, -1);
-        int move = solver.solve(board);
-        if (move == 7)
+        TournamentSolver solver(moveTime, 8, 1, -1);
+        mapTableFile(solver, tableFile);
+        int move = TournamentSolver::moveToPlay(board, solver.solve(board));
+
+        printStatistics(solver, statisticsFormat);
+        if (move == Board::width)
         {
             // Skip move
             return 0;
         }
-        else if (move == -1)
-        {
-            // Failed to complete iteration,
-            move = 3;
-        }
         std::cout << move << std::endl;
     }
     catch (std::invalid_argument &e)
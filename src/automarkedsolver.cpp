@@ -1,43 +1,124 @@
 #include "automarkedsolver.h"
+#include "bitboard.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
-#include <iostream>
+#include <thread>
 
 namespace ConnectFour
 {
+    // The search is compiled for x86 processors with and without a popcount instruction, to use it where it's
+    // available, as it is most of the cost of scoring leaves. The functions it calls must be inlined into each
+    // version to be compiled for it.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(__POPCNT__)
+#define POPCOUNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#define POPCOUNT_INLINE inline __attribute__((always_inline))
+#else
+#define POPCOUNT_CLONES
+#define POPCOUNT_INLINE inline
+#endif
+
+    // Bitboard layout from bitboard.h, where a spare bit above each column means connections never run from one
+    // column into the next
+    using Bitboards::columnBits;
+    using Bitboards::boardMask;
+
+    // Shifts to the next slot horizontally, vertically and along both diagonals
+    static const int shiftAmounts[] = { columnBits, 1, columnBits + 1, columnBits - 1 };
+    static const int shiftDirections = 4;
+
+    // Count the set bits in parallel. The builtin is a library call unless a popcount instruction is enabled, while
+    // GCC compiles this to the instruction when it is enabled and is fast without it.
+    static POPCOUNT_INLINE int popcount(std::uint64_t b)
+    {
+        b = b - ((b >> 1) & 0x5555555555555555ULL);
+        b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+        b = (b + (b >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<int>((b * 0x0101010101010101ULL) >> 56);
+    }
+
+    // Check whether the given pieces connect four
+    static POPCOUNT_INLINE bool isWin(std::uint64_t pieces)
+    {
+        for (int shift = 0; shift < shiftDirections; ++shift)
+        {
+            std::uint64_t b = pieces & (pieces >> shiftAmounts[shift]);
+            if (b & (b >> 2*shiftAmounts[shift])) return true;
+        }
+        return false;
+    }
+
+    // Compute score for the player with the given pieces: the number of pieces, and the number of connections of
+    // exactly 2 and 3 pieces in each direction, which are counted like Board::countConnections. Only positions
+    // where neither player has connected four are scored, so the connections of 4 are always 0.
+    static POPCOUNT_INLINE int score(std::uint64_t pieces)
+    {
+        assert(!isWin(pieces));
+        int value = popcount(pieces);
+        for (int shift = 0; shift < shiftDirections; ++shift)
+        {
+            // Count the pieces remaining after removing 1 from each group of pieces, twice. With no groups of 4,
+            // these are the groups of at least 2 and of exactly 3.
+            const int amount = shiftAmounts[shift];
+            std::uint64_t b = pieces & (pieces >> amount);
+            const int count0 = popcount(b);
+            b &= b >> amount;
+            const int count1 = popcount(b);
+
+            const int atleast2 = count0 - count1;
+            const int exactly3 = count1;
+            value += 10*(atleast2 - exactly3) + 100*exactly3;
+        }
+        return value;
+    }
+
     AutomarkedSolver::AutomarkedSolver(int maxDepth, bool prune) :
         prune(prune),
         maxDepth(maxDepth),
-        nodesExamined(0)
+        threads(1),
+        splitDepth(-1),
+        collectingSubtrees(false),
+        nextSubtree(0)
     {
         assert(maxDepth >= 0);
     }
 
-    // Get the best move from the given board, and updates outValue with the value for the best move
+    // Get the best move from the given position, and updates outValue with the value for the best move
     // Returns -1 if there are no legal moves or it is unknown
-    int AutomarkedSolver::bestMove(const Board &board, int *outValue, int depth, int alpha, int beta)
+    // The search order, values and node counts are the same as searching Board copies: children are searched from
+    // left to right, and the same terminal checks are made in the same order
+    POPCOUNT_CLONES int AutomarkedSolver::bestMove(bitboard current, bitboard mask, int *outValue, int depth, int alpha, int beta)
     {
-        ++nodesExamined;
+        if (depth == splitDepth)
+        {
+            return splitSubtree(current, mask, outValue);
+        }
+
+        stats.countNode(depth);
 
-        // Get the board from the opposite player's perspective
-        Board other(board);
-        other.swap();
+        // Get the pieces of the opposite player
+        const bitboard other = current ^ mask;
 
-        // Check for terminal node
-        if (board.isWin())
+        // Check for terminal node. The current player can only have won at the root, as otherwise the previous
+        // node would have found the win for its other player.
+        if (depth == 0 && isWin(current))
         {
+            ++stats.leafNodes;
             // This won't ever happen
             *outValue = 10000;
             return -1;
         }
-        else if (other.isWin())
+        else if (isWin(other))
         {
+            ++stats.leafNodes;
             *outValue = -10000;
             return -1;
         }
-        else if (board.count() + other.count() == Board::width*Board::height)
+        else if (mask == boardMask)
         {
             // Draw
+            ++stats.leafNodes;
             *outValue = 0;
             return -1;
         }
@@ -45,23 +126,28 @@ namespace ConnectFour
         // Check for leaf node
         if (depth == maxDepth)
         {
-            *outValue = score(board) - score(other);
+            ++stats.leafNodes;
+            *outValue = score(current) - score(other);
             return -1;
         }
 
+        ++stats.interiorNodes;
+
         // Compute the move in the next level with best minimax value for the current player
         int move = -1;
         int bestValue = std::numeric_limits<int>::min();
+        bool firstMove = true;
         // Check each possible move from left to right
         for (int col = 0; col < Board::width; ++col)
         {
-            if (!board.canPlay(col)) continue;
-            // Create copy of board with move performed
-            Board b(board);
-            b.play(col);
-            b.swap(); // Current player is now the other player
+            const bitboard bottom = bitboard(1) << (col * columnBits);
+            const bitboard column = ((bitboard(1) << Board::height) - 1) << (col * columnBits);
+            // The lowest empty slot of the column, which is outside of it if the column is full
+            const bitboard slot = (mask + bottom) & column;
+            if (!slot) continue;
             int value;
-            bestMove(b, &value, depth + 1, -beta, -alpha);
+            // The other player is now the current player
+            bestMove(other, mask | slot, &value, depth + 1, -beta, -alpha);
             // The move is evaluated in terms of the other player, so invert it
             value = -value;
             if (value > bestValue)
@@ -79,9 +165,15 @@ namespace ConnectFour
                 if (alpha >= beta)
                 {
                     // This branch will be too high for the previous player to choose it
+                    ++stats.cutoffs;
+                    if (firstMove)
+                    {
+                        ++stats.firstMoveCutoffs;
+                    }
                     break;
                 }
             }
+            firstMove = false;
         }
 
         *outValue = bestValue;
@@ -90,25 +182,112 @@ namespace ConnectFour
 
     int AutomarkedSolver::solve(const Board &board)
     {
-        nodesExamined = 0;
+        stats.startSearch();
+        stats.startIteration(maxDepth);
+
+        bitboard current, mask;
+        Bitboards::fromBoard(board, current, mask);
+
         int value;
-        return bestMove(board, &value, 0, std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max() - 1);
+        int move;
+        if (!prune && threads > 1 && maxDepth > splitPlies)
+        {
+            move = splitSearch(current, mask, &value);
+        }
+        else
+        {
+            move = bestMove(current, mask, &value, 0, std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max() - 1);
+        }
+        stats.endIteration(move, value);
+        finishStatistics();
+        return move;
     }
 
-    int AutomarkedSolver::numberOfNodesExamined() const
+    int AutomarkedSolver::splitSubtree(bitboard current, bitboard mask, int *outValue)
     {
-        return nodesExamined;
+        if (collectingSubtrees)
+        {
+            Subtree subtree = {};
+            subtree.current = current;
+            subtree.mask = mask;
+            subtrees.push_back(subtree);
+            // The value isn't used until the results are known
+            *outValue = 0;
+            return -1;
+        }
+
+        // The results are used in the same order that the positions were collected
+        const Subtree &subtree = subtrees[nextSubtree++];
+        assert(subtree.current == current && subtree.mask == mask);
+        stats.mergeCounts(subtree.stats);
+        *outValue = subtree.value;
+        return subtree.move;
     }
 
-    void AutomarkedSolver::printStatistics(std::ostream &out) const
+    int AutomarkedSolver::splitSearch(bitboard current, bitboard mask, int *outValue)
     {
-        out << "Nodes examined: " << nodesExamined << std::endl;
+        const int alpha = std::numeric_limits<int>::min() + 1;
+        const int beta = std::numeric_limits<int>::max() - 1;
+
+        // The nodes before the split depth are counted when the results are used, so they aren't counted here
+        const SearchStatistics before = stats;
+        subtrees.clear();
+        splitDepth = splitPlies;
+        collectingSubtrees = true;
+        bestMove(current, mask, outValue, 0, alpha, beta);
+        collectingSubtrees = false;
+        stats = before;
+
+        searchSubtrees();
+
+        nextSubtree = 0;
+        int move = bestMove(current, mask, outValue, 0, alpha, beta);
+        assert(nextSubtree == subtrees.size());
+        splitDepth = -1;
+        subtrees.clear();
+        return move;
     }
 
-    // Compute score for current player
-    int AutomarkedSolver::score(const Board &board)
+    void AutomarkedSolver::searchSubtrees()
     {
-        Board::connectionsArray connections = board.countConnections();
-        return board.count() + 10*connections[0] + 100*connections[1] + 1000*connections[2];
+        const int depth = splitDepth;
+        std::atomic<std::size_t> nextIndex(0);
+        auto work = [&]
+        {
+            // Each thread searches with its own solver, which has the same settings but doesn't split
+            AutomarkedSolver worker(maxDepth, prune);
+            for (std::size_t i = nextIndex++; i < subtrees.size(); i = nextIndex++)
+            {
+                Subtree &subtree = subtrees[i];
+                worker.stats.reset();
+                subtree.move = worker.bestMove(subtree.current, subtree.mask, &subtree.value, depth,
+                    std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max() - 1);
+                subtree.stats = worker.stats;
+            }
+        };
+
+        // This thread searches too, so one fewer is started
+        std::vector<std::thread> pool;
+        const int count = static_cast<int>(std::min<std::size_t>(threads, subtrees.size()));
+        for (int t = 1; t < count; ++t)
+        {
+            pool.push_back(std::thread(work));
+        }
+        work();
+        for (std::vector<std::thread>::iterator thread = pool.begin(); thread != pool.end(); ++thread)
+        {
+            thread->join();
+        }
     }
+
+    void AutomarkedSolver::setThreads(int threads)
+    {
+        this->threads = std::max(1, threads);
+    }
+
+    int AutomarkedSolver::numberOfNodesExamined() const
+    {
+        return static_cast<int>(stats.nodes);
+    }
+
 }
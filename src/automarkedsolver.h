@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 #include "solver.h"
 
 namespace ConnectFour
@@ -12,14 +14,53 @@ namespace ConnectFour
 
         int solve(const Board &board);
         int numberOfNodesExamined() const;
-        void printStatistics(std::ostream &out) const;
+
+        // Set the number of threads to search with. Only searches without pruning are split between threads, as
+        // their subtrees don't depend on each other. The move, value and node counts are the same as searching
+        // on one thread.
+        void setThreads(int threads);
 
     private:
+        // Bitboard with a column of Board::height + 1 bits for each column, as in EndgameSearch
+        typedef std::uint64_t bitboard;
+
+        // A position at the split depth, and the result of searching it
+        struct Subtree
+        {
+            bitboard current;
+            bitboard mask;
+            int value;
+            int move;
+            SearchStatistics stats;
+        };
+
+        // Number of plies searched before splitting the search between threads
+        static const int splitPlies = 2;
+
         const bool prune;
         const int maxDepth;
-        int nodesExamined;
+        int threads;
+
+        // Depth where the search is split, or -1 when it isn't
+        int splitDepth;
+        // Whether the positions at the split depth are being collected, rather than their results being used
+        bool collectingSubtrees;
+        // Positions at the split depth, in the order the search reaches them
+        std::vector<Subtree> subtrees;
+        // Next subtree result to use
+        std::size_t nextSubtree;
+
+        // Searches the position with the current player's pieces and every piece given, without copying boards
+        int bestMove(bitboard current, bitboard mask, int *outValue, int depth, int alpha, int beta);
+
+        // Collects or uses the result of a position at the split depth
+        int splitSubtree(bitboard current, bitboard mask, int *outValue);
+
+        // Searches the position by collecting the positions at the split depth, searching them on the threads, then
+        // searching the first plies again with their results
+        int splitSearch(bitboard current, bitboard mask, int *outValue);
 
-        int bestMove(const Board &board, int *outValue, int depth, int alpha, int beta);
-        static int score(const Board &board);
+        // Searches each collected subtree, with each thread taking the next one until there are none left
+        void searchSubtrees();
     };
 }
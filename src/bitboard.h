@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @brief Helpers for positions as 64 bit column-major bitboards, used by the searches that work on them
+    ///        instead of on Board.
+    ///
+    /// Bit column*(Board::height + 1) + row is set for each piece, with row 0 at the bottom and a spare bit above
+    /// each column so that connections never run from one column into the next. A position is given by the pieces
+    /// of the player to move and the mask of every piece on the board.
+    namespace Bitboards
+    {
+        typedef std::uint64_t bitboard;
+
+        constexpr int columnBits = Board::height + 1;
+
+        /// @brief Get the bottom slot of each of the first columns.
+        constexpr bitboard bottomMask(int columns = Board::width)
+        {
+            return columns == 0 ? 0 : bottomMask(columns - 1) | (bitboard(1) << ((columns - 1) * columnBits));
+        }
+
+        /// @brief The bottom slot of every column.
+        constexpr bitboard bottom = bottomMask();
+
+        /// @brief Every slot of the board.
+        constexpr bitboard boardMask = bottom * ((bitboard(1) << Board::height) - 1);
+
+        /// @brief Get the slots of a column.
+        constexpr bitboard columnMask(int column)
+        {
+            return ((bitboard(1) << Board::height) - 1) << (column * columnBits);
+        }
+
+        inline int popcount(bitboard b)
+        {
+#ifdef __GNUC__
+            return __builtin_popcountll(b);
+#else
+            int count = 0;
+            for (; b; b &= b - 1) ++count;
+            return count;
+#endif
+        }
+
+        /// @brief Get the empty slots that would connect four for the player with the given pieces.
+        inline bitboard winningSlots(bitboard player, bitboard mask)
+        {
+            // Vertical
+            bitboard slots = (player << 1) & (player << 2) & (player << 3);
+
+            // Horizontal and both diagonals, with a piece each side of the slot or three on one side
+            const int shifts[] = { columnBits, columnBits - 1, columnBits + 1 };
+            for (int i = 0; i < 3; ++i)
+            {
+                const int shift = shifts[i];
+                bitboard pair = (player << shift) & (player << 2*shift);
+                slots |= pair & (player << 3*shift);
+                slots |= pair & (player >> shift);
+                pair = (player >> shift) & (player >> 2*shift);
+                slots |= pair & (player << shift);
+                slots |= pair & (player >> 3*shift);
+            }
+
+            return slots & (boardMask ^ mask);
+        }
+
+        /// @brief Get the slots that can be played in next.
+        constexpr bitboard playableSlots(bitboard mask)
+        {
+            return (mask + bottom) & boardMask;
+        }
+
+        /// @brief Convert a board to bitboards.
+        /// @param[out] outCurrent The pieces of the player to move.
+        /// @param[out] outMask Every piece on the board.
+        inline void fromBoard(const Board &board, bitboard &outCurrent, bitboard &outMask)
+        {
+            outCurrent = 0;
+            outMask = 0;
+            const Board::bitset &currentPieces = board.getPieces(false);
+            const Board::bitset &otherPieces = board.getPieces(true);
+            for (int column = 0; column < Board::width; ++column)
+            {
+                for (int row = 0; row < Board::height; ++row)
+                {
+                    int bit = (Board::width + 1)*(Board::height - row) - column - 1;
+                    bitboard slot = bitboard(1) << (column * columnBits + row);
+                    if (currentPieces[bit]) outCurrent |= slot;
+                    if (currentPieces[bit] || otherPieces[bit]) outMask |= slot;
+                }
+            }
+        }
+    }
+}
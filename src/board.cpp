@@ -53,6 +53,14 @@ namespace ConnectFour
 		return false;
 	}
 
+	bool Board::isGameOver() const
+	{
+		if (isWin() || totalCount() == width*height) return true;
+		Board other(*this);
+		other.swap();
+		return other.isWin();
+	}
+
 	std::string Board::getWinningPiecesDescription(bool forYellow) const
 	{
 		Board::bitset winningPieces = 0;
@@ -122,19 +130,10 @@ namespace ConnectFour
 		otherHash ^= zobristNumbers[2*Board::width*Board::height - 1 - row*Board::width - column];
 	}
 
-	int Board::getFreeRow(int column)
+	int Board::getFreeRow(int column) const
 	{
-		Board::bitset board = currentPlayer ^ otherPlayer;
-		// Initialise mask with bit corresponding to the column set in bottom row
-		Board::bitset mask = Board::bitset(1) << ((Board::width + 1)*Board::height - column - 1);
-		int row = 0;
-		// Move bit up 1 row at a time until it is in a free spot
-		while ((mask & board) != 0 && row < Board::height)
-		{
-			mask >>= (Board::width + 1);
-			++row;
-		}
-		return row;
+		// Pieces are stacked from the bottom, so the count of pieces in the column is the free row
+		return static_cast<int>(((currentPlayer | otherPlayer) & getColumnMask(column)).count());
 	}
 
 	Board::connectionsArray Board::countConnections() const
@@ -189,6 +188,66 @@ namespace ConnectFour
 		return info;
 	}
 
+	Board::ParityInfo Board::getParityInfo() const
+	{
+		Board::ParityInfo info = {};
+
+		Board::bitset threats[2];
+		threats[0] = getThreats(false);
+		threats[1] = getThreats(true);
+
+		for (int column = 0; column < Board::width; ++column)
+		{
+			// Find the lowest threat of each player in the column
+			int lowest[2] = { Board::height, Board::height };
+			for (int row = Board::height - 1; row >= 0; --row)
+			{
+				int bit = (Board::width + 1)*(Board::height - row) - column - 1;
+				for (int player = 0; player < 2; ++player)
+				{
+					if (threats[player][bit]) lowest[player] = row;
+				}
+			}
+
+			for (int player = 0; player < 2; ++player)
+			{
+				// A threat above the other player's threat can't be reached
+				if (lowest[player] == Board::height || lowest[player] > lowest[1 - player]) continue;
+				// Rows are indexed from 0, so even indices are odd rows
+				if (lowest[player] % 2 == 0)
+				{
+					++info.oddThreats[player];
+					info.oddColumns[player] |= 1 << column;
+				}
+				else
+				{
+					++info.evenThreats[player];
+					info.evenColumns[player] |= 1 << column;
+				}
+			}
+		}
+
+		// Each player has made the same number of moves when the first player is to move
+		int first = (totalCount() % 2 == 0) ? 0 : 1;
+		int second = 1 - first;
+		if (info.oddThreats[first] > 0 && info.evenThreats[second] == 0 && info.oddThreats[second] == 0)
+		{
+			// The second player can't stop the first player getting the odd squares
+			info.controller = first;
+		}
+		else if (info.oddThreats[first] == 0 && info.evenThreats[second] > 1)
+		{
+			// The second player gets the even squares by following up, and one threat may be refuted
+			info.controller = second;
+		}
+		else
+		{
+			info.controller = -1;
+		}
+
+		return info;
+	}
+
 	Board::bitset Board::getThreats(bool bad) const
 	{
 		const Board::bitset emptySpots = (~(currentPlayer ^ otherPlayer)) & getBoardMask();
@@ -265,21 +324,49 @@ namespace ConnectFour
 		}
 	}
 
+	static Board::bitset makeBoardMask()
+	{
+		Board::bitset mask;
+		Board::bitset b(1);
+		for (int i = 0; i < Board::height; ++i)
+		{
+			mask |= b;
+			b <<= (Board::width + 1);
+		}
+		return ~mask;
+	}
+
 	const Board::bitset &Board::getBoardMask()
 	{
-		static Board::bitset mask;
-		if (mask == 0)
+		// Initialised once, so that boards can be used on several threads
+		static const Board::bitset mask = makeBoardMask();
+		return mask;
+	}
+
+	Board::bitset Board::getImmediateWins(bool bad) const
+	{
+		// Threats that have a piece below them or are on the bottom row
+		return getThreats(bad) & (((currentPlayer ^ otherPlayer) >> (Board::width + 1)) | getBottomMask());
+	}
+
+	static std::array<Board::bitset, Board::width> makeColumnMasks()
+	{
+		std::array<Board::bitset, Board::width> masks;
+		for (int column = 0; column < Board::width; ++column)
 		{
-			Board::bitset b(1);
-			for (int i = 0; i < Board::height; ++i)
+			for (int row = 0; row < Board::height; ++row)
 			{
-				mask |= b;
-				b <<= (Board::width + 1);
+				masks[column].set((Board::width + 1)*(Board::height - row) - column - 1);
 			}
-			mask = ~mask;
 		}
+		return masks;
+	}
 
-		return mask;
+	const Board::bitset &Board::getColumnMask(int column)
+	{
+		assert(column >= 0 && column < Board::width);
+		static const std::array<Board::bitset, Board::width> masks = makeColumnMasks();
+		return masks[column];
 	}
 
 	const Board::bitset &Board::getBottomMask()
@@ -343,19 +430,24 @@ namespace ConnectFour
 
 	void Board::setFromDescription(const std::string &description)
 	{
-		clear();
+		setFromDescription(description.c_str());
+	}
 
-		// Set the bits for the board, starting at the most significant
+	void Board::setFromDescription(const char *description)
+	{
+		// Set the bits for the board, starting at the most significant. They are collected in integers, which
+		// are cheaper to shift than the bitsets.
+		unsigned long long current = 0, other = 0;
 		int bit = 0;
-		for (std::string::const_iterator i = description.begin(); i != description.end(); ++i)
+		for (const char *i = description; *i != '\0'; ++i)
 		{
 			if (*i == currentPlayerChar)
 			{
-				currentPlayer |= 1;
+				current |= 1;
 			}
 			else if (*i == otherPlayerChar)
 			{
-				otherPlayer |= 1;
+				other |= 1;
 			}
 			#ifndef NDEBUG
 			else if (*i == rowSeperatorChar)
@@ -373,8 +465,8 @@ namespace ConnectFour
 			#endif
 
 			// Move to the next bit
-			currentPlayer <<= 1;
-			otherPlayer <<= 1;
+			current <<= 1;
+			other <<= 1;
 			++bit;
 		}
 
@@ -386,11 +478,61 @@ namespace ConnectFour
 		}
 		#endif
 
+		currentPlayer = Board::bitset(current);
+		otherPlayer = Board::bitset(other);
 		assert((currentPlayer & otherPlayer) == 0);
 
 		resetHashes();
 	}
 
+	std::uint64_t Board::getKey() const
+	{
+		std::uint64_t key = 0;
+		for (int column = 0; column < Board::width; ++column)
+		{
+			const int height = getFreeRow(column);
+			for (int row = 0; row < height; ++row)
+			{
+				if (currentPlayer[(Board::width + 1)*(Board::height - row) - column - 1])
+				{
+					key |= std::uint64_t(1) << (column*(Board::height + 1) + row);
+				}
+			}
+			key |= std::uint64_t(1) << (column*(Board::height + 1) + height);
+		}
+		return key;
+	}
+
+	void Board::setFromKey(std::uint64_t key)
+	{
+		clear();
+		for (int column = 0; column < Board::width; ++column)
+		{
+			const int bits = static_cast<int>((key >> (column*(Board::height + 1))) & ((1 << (Board::height + 1)) - 1));
+			if (bits == 0)
+			{
+				throw std::invalid_argument("Key has a column without a height");
+			}
+			// The height is the position of the highest bit
+			int height = Board::height;
+			while (!(bits & (1 << height))) --height;
+
+			for (int row = 0; row < height; ++row)
+			{
+				const int bit = (Board::width + 1)*(Board::height - row) - column - 1;
+				if (bits & (1 << row))
+				{
+					currentPlayer[bit] = true;
+				}
+				else
+				{
+					otherPlayer[bit] = true;
+				}
+			}
+		}
+		resetHashes();
+	}
+
 	std::ostream& operator<<(std::ostream& os, const Board& b)
 	{
 		os << b.getDescription();
@@ -30,6 +30,9 @@ namespace ConnectFour
 		/// @brief Check whether the current player has connected 4.
 		bool isWin() const;
 
+		/// @brief Check whether the game has ended, because either player has connected 4 or the board is full.
+		bool isGameOver() const;
+
 		/// @brief Get a count of the current player's pieces on the board.
 		int count() const { return currentPlayer.count(); }
 
@@ -47,7 +50,7 @@ namespace ConnectFour
 		/// @brief Get the row of the bottom-most free spot in a column.
 		/// @param column The column to check for a free spot within.
 		/// @return Index of the row from the bottom. May be outside range of rows if there is no free spot.
-		int getFreeRow(int column);
+		int getFreeRow(int column) const;
 
 		/// @brief Type for representing a Board hash.
 		typedef unsigned int Hash;
@@ -74,6 +77,45 @@ namespace ConnectFour
 		/// @return The difference in number of threats.
 		ThreatInfo getThreatInfo() const;
 
+		/// @brief Stores threats classified by the parity of their row, for both players.
+		///        Rows are counted from 1 at the bottom, and only the lowest threat of each player in a column is
+		///        counted, unless the other player has a lower threat in the column.
+		struct ParityInfo
+		{
+			int oddThreats[2]; // Columns with a threat on an odd row
+			int evenThreats[2]; // Columns with a threat on an even row
+			int oddColumns[2]; // Bitmask of the columns with a threat on an odd row
+			int evenColumns[2]; // Bitmask of the columns with a threat on an even row
+			int controller; // Player that controls the zugzwang and so is predicted to win: 0 current, 1 other, -1 neither
+		};
+
+		/// @brief Classify threats by row parity to predict which player wins by zugzwang in the standard game.
+		///        The player who moved first is predicted to win with an odd threat when the other player has no
+		///        threats, and the second player with two even threats when the first player has no odd threats.
+		/// @return Threat counts for index 0 the current player and 1 the other player.
+		ParityInfo getParityInfo() const;
+
+		/// @brief Type for representing a bit for each board slot.
+		///        Order of bits is row-major order with most significant bit representing the lower left piece.
+		///        There is a zero bit after each row to avoid erroneous matches between adjacent rows.
+		typedef std::bitset<(width + 1)*height> bitset;
+
+		/// @brief Get a board of possible threats: slots that would allow connecting-four.
+		/// @param bad Whether to find threats against current player. Otherwise finds threats against other player.
+		bitset getThreats(bool bad) const;
+
+		/// @brief Get the slots occupied by a player.
+		/// @param other Whether to get the other player's pieces. Otherwise gets the current player's.
+		const bitset &getPieces(bool other) const { return other ? otherPlayer : currentPlayer; }
+
+		/// @brief Get the slots where a player would connect four by playing in them immediately.
+		/// @param bad Whether to find the other player's winning slots. Otherwise finds the current player's.
+		bitset getImmediateWins(bool bad) const;
+
+		/// @brief Get a bitmask for every slot in a column.
+		/// @param column The column to get the mask for. Must be a valid column.
+		static const bitset &getColumnMask(int column);
+
 		/// @brief Get a string representation for the board with red as the current player.
 		/// @param row Optional parameter specifying a single row to limit the description to.
 		std::string getDescription(int row = -1, bool showThreats = false) const;
@@ -86,6 +128,18 @@ namespace ConnectFour
 		/// @param description String description of a board. invalid_argument is thrown if it is invalid.
 		void setFromDescription(const std::string &description);
 
+		/// @brief Set the board state based on the given null terminated description, without copying it.
+		void setFromDescription(const char *description);
+
+		/// @brief Get a compact binary encoding of the board, that is unique for each board.
+		///        Bit column*(height + 1) + row is set for each of the current player's pieces, and a bit is set
+		///        above the top piece of each column to mark its height.
+		std::uint64_t getKey() const;
+
+		/// @brief Set the board state from a binary encoding made by getKey.
+		/// @param key The encoding. invalid_argument is thrown if a column has no height marker.
+		void setFromKey(std::uint64_t key);
+
 		/// @brief Output board descriptions from a Board into an output stream.
 		friend std::ostream& operator<<(std::ostream& os, const Board& b);
 
@@ -95,9 +149,6 @@ namespace ConnectFour
 	private:
 		// Data representing the positions of each of the players pieces.
 		// A 1 represents piece existing, 0 represents no piece (for the player).
-		// Order of bits is row-major order with most significant bit representing the lower left piece.
-		// There is a zero bit after each row to avoid erroneous matches between adjacent rows.
-		typedef std::bitset<(width + 1)*height> bitset;
 		bitset currentPlayer, otherPlayer;
 
 		/// @breif Get a bitmask for a board with piece in every slot
@@ -121,10 +172,6 @@ namespace ConnectFour
 		// Recalculate hash values
 		void resetHashes();
 
-		/// @brief Get a board of possible threats: slots that would allow connecting-four.
-		/// @param bad Whether to find threats against current player. Otherwise finds threats against other player.
-		bitset getThreats(bool bad) const;
-
 		/// @brief Unset bits in threats that correspond to threats that can't be exploited
 		/// @param[in,out] threats The threats to filter
 		/// @param otherThreats The other player's threats which may prevent exploiting our own threats.
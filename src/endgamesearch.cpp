@@ -0,0 +1,216 @@
+#include "endgamesearch.h"
+#include "bitboard.h"
+#include <cassert>
+#include <algorithm>
+
+namespace ConnectFour
+{
+    using namespace Bitboards;
+
+    // Columns in the order they are searched, centre first
+    static const int columnOrder[Board::width] = { 3, 2, 4, 1, 5, 0, 6 };
+
+    EndgameSearch::EndgameSearch(int tableSize) :
+        tableSize(tableSize),
+        stats(0),
+        rootPieces(0),
+        stopRequested(0),
+        nodesUntilCheck(0),
+        stopped(false)
+    {
+        assert(tableSize > 0);
+    }
+
+    void EndgameSearch::clear()
+    {
+        table.clear();
+    }
+
+    int EndgameSearch::bestMove(const Board &board, Result *outResult, SearchStatistics &stats, clock::time_point endTime,
+        const std::atomic<bool> &stopRequested)
+    {
+        if (table.empty())
+        {
+            // The key of every position is less than the board mask doubled, so the empty entries never match
+            Entry empty = { ~bitboard(0), result_loss, result_win };
+            table.resize(tableSize, empty);
+        }
+        this->stats = &stats;
+        this->endTime = endTime;
+        this->stopRequested = &stopRequested;
+        // The limits are checked at the first node, as a stop may have been requested already
+        nodesUntilCheck = 1;
+        stopped = false;
+        rootPieces = board.totalCount();
+
+        bitboard current, mask;
+        fromBoard(board, current, mask);
+
+        const bitboard playable = playableSlots(mask);
+        const bitboard wins = winningSlots(current, mask) & playable;
+        for (int column = 0; column < Board::width; ++column)
+        {
+            if (wins & columnMask(column))
+            {
+                *outResult = result_win;
+                return column;
+            }
+        }
+
+        // Test for each result from best to worst whether a move achieves it, with null windows. The table keeps
+        // the bounds proven by earlier searches in the game, so results that are already known need no search.
+        const bitboard key = current + mask;
+        const Entry &entry = table[key % tableSize];
+        const int upper = (entry.key == key) ? entry.upper : result_win;
+        const int lower = (entry.key == key) ? entry.lower : result_loss;
+        for (int target = upper; target >= std::max(lower, int(result_draw)); --target)
+        {
+            for (int i = 0; i < Board::width; ++i)
+            {
+                const int column = columnOrder[i];
+                const bitboard slot = playable & columnMask(column);
+                if (!slot) continue;
+
+                // The other player's pieces become the current player's
+                const int value = -search(current ^ mask, mask | slot, -target, -target + 1);
+                if (stopped) return -1;
+                if (value >= target)
+                {
+                    store(key, target, target);
+                    *outResult = static_cast<Result>(target);
+                    return column;
+                }
+            }
+        }
+
+        // Every move loses
+        store(key, result_loss, result_loss);
+        *outResult = result_loss;
+        for (int i = 0; i < Board::width; ++i)
+        {
+            if (playable & columnMask(columnOrder[i])) return columnOrder[i];
+        }
+        *outResult = result_draw;
+        return -1;
+    }
+
+    int EndgameSearch::search(bitboard current, bitboard mask, int alpha, int beta)
+    {
+        assert(alpha < beta);
+        ++stats->endgameNodes;
+        stats->countNode(popcount(mask) - rootPieces);
+        if (--nodesUntilCheck == 0)
+        {
+            nodesUntilCheck = timeCheckInterval;
+            stopped = *stopRequested || clock::now() >= endTime;
+        }
+        if (stopped) return alpha;
+
+        bitboard playable = playableSlots(mask);
+        if (!playable)
+        {
+            // Draw (full board)
+            return result_draw;
+        }
+        if (winningSlots(current, mask) & playable)
+        {
+            return result_win;
+        }
+
+        // A threat the other player can play must be blocked, and two can't be
+        const bitboard otherWins = winningSlots(current ^ mask, mask);
+        const bitboard forced = playable & otherWins;
+        if (forced)
+        {
+            if (forced & (forced - 1)) return result_loss;
+            playable = forced;
+        }
+        // Don't play directly below one of the other player's threats
+        playable &= ~(otherWins >> 1);
+        if (!playable)
+        {
+            return result_loss;
+        }
+        if (popcount(mask) >= Board::width*Board::height - 2)
+        {
+            // Neither player can win with the last two pieces
+            return result_draw;
+        }
+
+        // Check the table for bounds on the result
+        const bitboard key = current + mask;
+        Entry &entry = table[key % tableSize];
+        if (entry.key == key)
+        {
+            ++stats->endgameTableHits;
+            if (entry.lower >= beta) return entry.lower;
+            if (entry.upper <= alpha) return entry.upper;
+            alpha = std::max(alpha, int(entry.lower));
+            beta = std::min(beta, int(entry.upper));
+            if (alpha >= beta) return alpha;
+        }
+
+        // Order moves by the number of threats they create, then closeness to the centre
+        bitboard moves[Board::width];
+        int scores[Board::width];
+        int moveCount = 0;
+        for (int i = 0; i < Board::width; ++i)
+        {
+            const bitboard slot = playable & columnMask(columnOrder[i]);
+            if (!slot) continue;
+            const int score = popcount(winningSlots(current | slot, mask | slot));
+            int j = moveCount++;
+            for (; j > 0 && scores[j - 1] < score; --j)
+            {
+                moves[j] = moves[j - 1];
+                scores[j] = scores[j - 1];
+            }
+            moves[j] = slot;
+            scores[j] = score;
+        }
+
+        const int originalAlpha = alpha;
+        int value = result_loss;
+        for (int i = 0; i < moveCount; ++i)
+        {
+            int childValue = -search(current ^ mask, mask | moves[i], -beta, -alpha);
+            // The partial result isn't stored
+            if (stopped) return alpha;
+            if (childValue > value)
+            {
+                value = childValue;
+                if (value > alpha) alpha = value;
+                if (alpha >= beta) break;
+            }
+        }
+
+        // The result is a lower bound after a cutoff and an upper bound if nothing beat alpha
+        if (value >= beta)
+        {
+            store(key, value, result_win);
+        }
+        else if (value <= originalAlpha)
+        {
+            store(key, result_loss, value);
+        }
+        else
+        {
+            store(key, value, value);
+        }
+        return value;
+    }
+
+    void EndgameSearch::store(bitboard key, int lower, int upper)
+    {
+        Entry &entry = table[key % tableSize];
+        if (entry.key == key)
+        {
+            // Combine with the bounds already known
+            lower = std::max(lower, int(entry.lower));
+            upper = std::min(upper, int(entry.upper));
+        }
+        entry.key = key;
+        entry.lower = static_cast<signed char>(lower);
+        entry.upper = static_cast<signed char>(upper);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+#include "statistics.h"
+
+namespace ConnectFour
+{
+    /// @class EndgameSearch
+    /// @brief Exact win/draw/loss search for positions with few empty slots, in the standard game.
+    ///
+    /// Positions are converted to 64 bit bitboards with a column of height + 1 bits for each column, so that a
+    /// move is a single addition. Values are only the game theoretic result, so the windows are tiny and the
+    /// search proves the result far faster than the heuristic search can reach the end of the game. Results
+    /// are kept in a table that persists between searches, so later positions in the same game usually need
+    /// little or no searching.
+    class EndgameSearch
+    {
+    public:
+        /// @brief Game theoretic result for the current player.
+        enum Result
+        {
+            result_loss = -1,
+            result_draw = 0,
+            result_win = 1
+        };
+
+        /// @brief Default number of table entries: 2^18 - 4MB
+        static const int defaultTableSize = 262144;
+
+        typedef std::chrono::steady_clock clock;
+
+        /// @brief Construct a search. The table is only allocated when it is first used.
+        explicit EndgameSearch(int tableSize = defaultTableSize);
+
+        /// @brief Find a move achieving the best result from the given board.
+        /// @param board A board position where neither player has won.
+        /// @param[out] outResult The result of the board for the current player.
+        /// @param stats Statistics to record the nodes and table hits in.
+        /// @param endTime The time at which to give up the search.
+        /// @param stopRequested Set by another thread to give up the search.
+        /// @return The column to play, or -1 if the board is full or the search was given up.
+        int bestMove(const Board &board, Result *outResult, SearchStatistics &stats, clock::time_point endTime,
+            const std::atomic<bool> &stopRequested);
+
+        /// @brief Whether the last call to bestMove was given up before it found the result.
+        bool wasStopped() const { return stopped; }
+
+        /// @brief Remove all results from the table.
+        void clear();
+
+    private:
+        typedef std::uint64_t bitboard;
+
+        // Bounds on the result of a position, keyed by the unique value current + mask
+        struct Entry
+        {
+            bitboard key;
+            signed char lower;
+            signed char upper;
+        };
+
+        const int tableSize;
+        std::vector<Entry> table;
+        SearchStatistics *stats;
+
+        // Number of pieces on the board searched by bestMove, to find the ply of nodes for statistics
+        int rootPieces;
+
+        // Limits of the current search, which are checked every timeCheckInterval nodes
+        clock::time_point endTime;
+        const std::atomic<bool> *stopRequested;
+        int nodesUntilCheck;
+        bool stopped;
+        static const int timeCheckInterval = 4096;
+
+        /// @brief Get the result of a position, as long as it is between alpha and beta.
+        ///        The result is meaningless if the search is stopped.
+        /// @param current The current player's pieces.
+        /// @param mask Every piece on the board.
+        int search(bitboard current, bitboard mask, int alpha, int beta);
+
+        /// @brief Store bounds on the result of a position.
+        void store(bitboard key, int lower, int upper);
+    };
+}
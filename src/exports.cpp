@@ -1,53 +1,303 @@
 #include "exports.h"
-#include <cstdlib>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 #include "board.h"
 #include "mainsolver.h"
 
-static ConnectFour::MainSolver solver(20000, 13, 1, 13);
+using ConnectFour::Board;
+using ConnectFour::MainSolver;
+using ConnectFour::SharedMainSolver;
+using ConnectFour::SharedTranspositionTable;
+
+// Start depth when the depth isn't limited
+static const int defaultStartDepth = 8;
+
+/// @brief A solver, and with more than one thread the helpers that search with it, sharing its transposition table.
+struct SolverHandle
+{
+    explicit SolverHandle(const SolverSettings &settings)
+    {
+        if (settings.threads == 1)
+        {
+            // Without helpers the table needn't be shared, and the unshared table is faster
+            single.reset(new MainSolver(settings.maxSolveTime, startDepth(settings, 0), 1, settings.maxDepth, settings.tableSize));
+            single->setKeepTable(true);
+            return;
+        }
+
+        solver.reset(new SharedMainSolver(settings.maxSolveTime, startDepth(settings, 0), 1, settings.maxDepth, settings.tableSize));
+        // The table is cleared before each search instead, as the helpers are still storing entries when a solve ends
+        solver->setKeepTable(true);
+        for (int i = 1; i < settings.threads; ++i)
+        {
+            helpers.emplace_back(new SharedMainSolver(settings.maxSolveTime, startDepth(settings, i), 1, settings.maxDepth, SharedTranspositionTable::bucketSize));
+            helpers.back()->transpositionTable().share(solver->transpositionTable());
+            helpers.back()->setKeepTable(true);
+        }
+    }
+
+    // Lock so that searches with the same handle are run one at a time
+    std::mutex mutex;
+    // Solver for a single thread, or null if there are several
+    std::unique_ptr<MainSolver> single;
+    // Solver giving the results with several threads
+    std::unique_ptr<SharedMainSolver> solver;
+    // Solvers on other threads, that only fill the table
+    std::vector<std::unique_ptr<SharedMainSolver>> helpers;
+
+    /// @brief Get the start depth for a solver, where every other helper starts a ply shallower so that the
+    ///        helpers don't all search the same tree as the solver.
+    static int startDepth(const SolverSettings &settings, int helper)
+    {
+        int depth = settings.maxDepth == -1 ? defaultStartDepth : settings.maxDepth;
+        return depth > 1 ? depth - helper % 2 : depth;
+    }
+};
 
 /// @brief Set board based on description in a cstring
-static void setBoardFromCString(ConnectFour::Board &board, const char *cstring, bool yellow = false)
+static void setBoardFromCString(Board &board, const char *cstring, bool yellow = false)
 {
-    std::string boardString(cstring);
-    board.setFromDescription(boardString);
+    board.setFromDescription(cstring);
     if (yellow)
     {
         board.swap();
     }
 }
 
-void configure()
+/// @brief Start each of a handle's helpers running a task on its own thread.
+/// @param task Function taking a helper solver.
+/// @return The threads started, for the first helpers. Fewer are started if threads aren't available.
+template <class Task>
+static std::vector<std::thread> startHelpers(SolverHandle &handle, Task task)
 {
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < handle.helpers.size(); ++i)
+    {
+        SharedMainSolver *helper = handle.helpers[i].get();
+        helper->clearStop();
+        try
+        {
+            threads.push_back(std::thread([helper, task] { task(*helper); }));
+        }
+        catch (std::system_error &)
+        {
+            // Threads aren't available, continue with those that started
+            break;
+        }
+    }
+    return threads;
+}
 
+/// @brief Wait for the threads started by startHelpers, asking their solves to finish first if stop is set.
+static void joinHelpers(SolverHandle &handle, std::vector<std::thread> &threads, bool stop)
+{
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        if (stop) handle.helpers[i]->stop();
+        threads[i].join();
+    }
 }
 
-int computeMove(const char *boardString, bool yellow)
+/// @brief Run a search with a handle's solver, while any helpers search the same board on other threads.
+/// @param search Function object taking either type of solver and the board, and returning the move found.
+template <class Search>
+static int searchWithHelpers(SolverHandle &handle, const Board &board, Search search)
 {
-    ConnectFour::Board board;
-    setBoardFromCString(board, boardString, yellow);
-    return solver.solve(board);
+    std::lock_guard<std::mutex> lock(handle.mutex);
+    if (handle.single)
+    {
+        handle.single->transpositionTable().clear();
+        return search(*handle.single, board);
+    }
+
+    handle.solver->transpositionTable().clear();
+    std::vector<std::thread> threads = startHelpers(handle, [board](SharedMainSolver &helper) { helper.solve(board); });
+    int move = search(*handle.solver, board);
+    joinHelpers(handle, threads, true);
+    return move;
 }
 
-int rowForMove(const char *boardString, int column)
+/// @brief Search for the move to play with a solver.
+struct SolveSearch
+{
+    template <class SolverType>
+    int operator()(SolverType &solver, const Board &board) const { return solver.solve(board); }
+};
+
+/// @brief Analyse every move with a solver, storing the value and type of each.
+struct AnalyseSearch
+{
+    int *outValues;
+    int *outTypes;
+
+    template <class SolverType>
+    int operator()(SolverType &solver, const Board &board) const
+    {
+        typename SolverType::AnalysisArray analysis;
+        int move = solver.analyse(board, analysis);
+        for (int column = 0; column < Board::width; ++column)
+        {
+            outValues[column] = analysis[column].value;
+            outTypes[column] = analysis[column].type;
+        }
+        return move;
+    }
+};
+
+/// @brief Solve boards from a batch until there are none left, taking the next board each time.
+struct BatchWork
 {
-    ConnectFour::Board board;
-    setBoardFromCString(board, boardString);
-    return board.getFreeRow(column);
+    const char *const *boardStrings;
+    const bool *yellow;
+    int count;
+    int *outMoves;
+    std::atomic<int> *next;
+    std::atomic<int> *found;
+
+    template <class SolverType>
+    void operator()(SolverType &solver) const
+    {
+        for (int i = (*next)++; i < count; i = (*next)++)
+        {
+            try
+            {
+                Board board;
+                setBoardFromCString(board, boardStrings[i], yellow[i]);
+                outMoves[i] = solver.solve(board);
+            }
+            catch (std::exception &)
+            {
+                outMoves[i] = -1;
+            }
+            if (outMoves[i] != -1) ++*found;
+        }
+    }
+};
+
+void defaultSolverSettings(SolverSettings *outSettings)
+{
+    outSettings->maxSolveTime = 20000;
+    outSettings->maxDepth = 13;
+    outSettings->threads = 1;
+    outSettings->tableSize = SharedTranspositionTable::defaultSize;
 }
 
-const char *winningPieces(const char *boardString, bool yellow)
+SolverHandle *createSolver(const SolverSettings *settings)
 {
-    ConnectFour::Board board;
-    setBoardFromCString(board, boardString);
-    std::string winners = board.getWinningPiecesDescription(yellow);
-    if (winners.empty())
+    SolverSettings defaults;
+    defaultSolverSettings(&defaults);
+    const SolverSettings &s = settings ? *settings : defaults;
+    if (s.maxSolveTime <= 0 || (s.maxDepth != -1 && s.maxDepth <= 0) || s.threads <= 0 ||
+        s.tableSize < SharedTranspositionTable::bucketSize || s.tableSize % SharedTranspositionTable::bucketSize != 0)
     {
         return NULL;
     }
-    else
+    try
+    {
+        return new SolverHandle(s);
+    }
+    catch (std::exception &)
+    {
+        return NULL;
+    }
+}
+
+void destroySolver(SolverHandle *solver)
+{
+    delete solver;
+}
+
+int computeMove(SolverHandle *solver, const char *boardString, bool yellow)
+{
+    try
+    {
+        Board board;
+        setBoardFromCString(board, boardString, yellow);
+        return searchWithHelpers(*solver, board, SolveSearch());
+    }
+    catch (std::exception &)
+    {
+        return -1;
+    }
+}
+
+int computeMoves(SolverHandle *solver, const char *const *boardStrings, const bool *yellow, int count, int *outMoves)
+{
+    std::lock_guard<std::mutex> lock(solver->mutex);
+
+    // Each solver takes the next board to solve until there are none left
+    std::atomic<int> next(0), found(0);
+    BatchWork work = { boardStrings, yellow, count, outMoves, &next, &found };
+    if (solver->single)
+    {
+        // The table is kept for the whole batch, as its entries are valid for any board
+        solver->single->transpositionTable().clear();
+        work(*solver->single);
+        return found;
+    }
+
+    solver->solver->transpositionTable().clear();
+    std::vector<std::thread> threads = startHelpers(*solver, work);
+    work(*solver->solver);
+    joinHelpers(*solver, threads, false);
+    return found;
+}
+
+int analyseMoves(SolverHandle *solver, const char *boardString, bool yellow, int *outValues, int *outTypes)
+{
+    try
+    {
+        Board board;
+        setBoardFromCString(board, boardString, yellow);
+        AnalyseSearch search = { outValues, outTypes };
+        return searchWithHelpers(*solver, board, search);
+    }
+    catch (std::exception &)
+    {
+        return -1;
+    }
+}
+
+int rowForMove(const char *boardString, int column)
+{
+    try
+    {
+        Board board;
+        setBoardFromCString(board, boardString);
+        return board.getFreeRow(column);
+    }
+    catch (std::exception &)
+    {
+        return -1;
+    }
+}
+
+int winningPieces(const char *boardString, bool yellow, char *outBuffer, int bufferSize)
+{
+    std::string winners;
+    try
+    {
+        Board board;
+        setBoardFromCString(board, boardString);
+        winners = board.getWinningPiecesDescription(yellow);
+    }
+    catch (std::exception &)
+    {
+        winners.clear();
+    }
+    if (bufferSize > 0)
     {
-        return strdup(winners.c_str());
+        std::size_t copied = std::min(winners.size(), static_cast<std::size_t>(bufferSize - 1));
+        std::memcpy(outBuffer, winners.data(), copied);
+        outBuffer[copied] = '\0';
     }
+    return static_cast<int>(winners.size());
 }
@@ -1,25 +1,94 @@
+#pragma once
+
+#ifdef __cplusplus
 extern "C"
 {
+#else
+#include <stdbool.h>
+#endif
+    /**
+     * Settings for creating a solver.
+     */
+    typedef struct SolverSettings
+    {
+        int maxSolveTime; // Time limit for each solve in milliseconds
+        int maxDepth; // Depth of the search tree, or -1 to keep deepening until the time limit
+        int threads; // Threads searching each position together, sharing the transposition table
+        int tableSize; // Entries in the transposition table, a positive multiple of 2
+    } SolverSettings;
+
+    /**
+     * Opaque handle for a solver. Each handle has its own transposition table, so different handles can be used
+     * from different threads at once. Calls using the same handle are run one at a time.
+     */
+    typedef struct SolverHandle SolverHandle;
+
+    /**
+     * Fill in the default settings: 20 seconds, depth 13, one thread and the default table size.
+     *
+     * @param outSettings Settings to fill in.
+     */
+    void defaultSolverSettings(SolverSettings *outSettings);
+
+    /**
+     * Create a solver.
+     *
+     * @param settings Settings for the solver, or NULL for the defaults.
+     * @return Handle for the solver, or NULL if the settings are invalid or it couldn't be allocated.
+     *  Must be destroyed with destroySolver.
+     */
+    SolverHandle *createSolver(const SolverSettings *settings);
+
     /**
-     * Configure the AI. Must be called before using the computeMove function.
+     * Destroy a solver created by createSolver. Does nothing if the handle is NULL.
+     *
+     * @param solver Handle of the solver, which must not be in use.
      */
-    void configure();
+    void destroySolver(SolverHandle *solver);
 
     /**
      * Use the AI to determine which column to play in.
      *
+     * @param solver Handle of the solver to use.
+     * @param board C string representing the board.
+     * @param yellow Whether the current player is yellow rather than red.
+     * @return The index of column to play in, or -1 if no move was found or the board is invalid.
+     */
+    int computeMove(SolverHandle *solver, const char *board, bool yellow);
+
+    /**
+     * Use the AI to determine which column to play in for each of several boards. The boards are shared between
+     * the solver's threads, which each solve whole boards and share one transposition table for the batch.
+     *
+     * @param solver Handle of the solver to use.
+     * @param boards Array of C strings representing the boards.
+     * @param yellow Array of whether the current player is yellow rather than red, for each board.
+     * @param count Number of boards.
+     * @param outMoves Array to store the index of the column to play in for each board, or -1 if no move was found
+     *  or the board is invalid.
+     * @return The number of boards a move was found for.
+     */
+    int computeMoves(SolverHandle *solver, const char *const *boards, const bool *yellow, int count, int *outMoves);
+
+    /**
+     * Use the AI to determine the value of every column (multi-PV analysis).
+     *
+     * @param solver Handle of the solver to use.
      * @param board C string representing the board.
      * @param yellow Whether the current player is yellow rather than red.
-     * @return The index of column to play in.
+     * @param outValues Array of 7 integers to store the value of playing in each column.
+     * @param outTypes Array of 7 integers to store the type of each value: 0 for exact, 1 for an upper bound,
+     *  2 for a lower bound or -1 if the column can't be played.
+     * @return The index of the column with the best value, or -1 if there is none or the board is invalid.
      */
-    int computeMove(const char *board, bool yellow);
+    int analyseMoves(SolverHandle *solver, const char *board, bool yellow, int *outValues, int *outTypes);
 
     /**
      * Calculate which row a piece would land in for the given column.
      *
      * @param board C string representing the board.
      * @param column The column being played into.
-     * @return Index of the row from the bottom. May be a row above the playing field.
+     * @return Index of the row from the bottom, or -1 if the board is invalid. May be a row above the playing field.
      */
     int rowForMove(const char *board, int column);
 
@@ -28,8 +97,13 @@ extern "C"
      *
      * @param board C string representing the board.
      * @param yellow Whether to get the winning pieces for yellow rather than red.
-     * @return C string representation of the board containing only the winning pieces,
-     *  or empty string if the player has not won. Must be freed if not NULL.
+     * @param outBuffer Buffer to write the C string representation of the board containing only the winning
+     *  pieces to. It is truncated to fit, and always terminated if bufferSize is positive.
+     * @param bufferSize Size of the buffer in bytes.
+     * @return Length of the representation without the terminator, which didn't fit if it isn't less than
+     *  bufferSize, or 0 if the player has not won or the board is invalid.
      */
-    const char *winningPieces(const char *board, bool yellow);
+    int winningPieces(const char *board, bool yellow, char *outBuffer, int bufferSize);
+#ifdef __cplusplus
 }
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ConnectFour
+{
+    /// @class LineSocket
+    /// @brief A connected Unix domain stream socket that sends and receives text a line at a time.
+    ///        Only used by the daemon and its client, so it is kept out of the shared objects.
+    class LineSocket
+    {
+    public:
+        /// @brief Take ownership of a connected socket, which is closed on destruction.
+        explicit LineSocket(int fd) : fd(fd) {}
+        ~LineSocket() { if (fd != -1) close(fd); }
+
+        /// @brief Connect to the socket at a path.
+        /// @return The socket descriptor, or -1 if it couldn't connect.
+        static int connectTo(const std::string &path)
+        {
+            sockaddr_un address;
+            if (!makeAddress(path, address)) return -1;
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1) return -1;
+            if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1)
+            {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        /// @brief Listen on a socket at a path, replacing any file there.
+        /// @return The listening socket descriptor, or -1 if it couldn't listen.
+        static int listenOn(const std::string &path, int backlog)
+        {
+            sockaddr_un address;
+            if (!makeAddress(path, address)) return -1;
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1) return -1;
+            unlink(path.c_str());
+            if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 || listen(fd, backlog) == -1)
+            {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        /// @brief Read the next line, without its newline.
+        /// @return Whether a line was read, false once the connection is closed.
+        bool readLine(std::string &line)
+        {
+            std::string::size_type end;
+            while ((end = buffer.find('\n')) == std::string::npos)
+            {
+                char data[4096];
+                ssize_t count = recv(fd, data, sizeof(data), 0);
+                if (count <= 0) return false;
+                buffer.append(data, count);
+            }
+            line.assign(buffer, 0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+
+        /// @brief Write a line, adding the newline.
+        /// @return Whether the whole line was written.
+        bool writeLine(const std::string &line)
+        {
+            std::string data = line + '\n';
+            std::string::size_type written = 0;
+            while (written < data.size())
+            {
+                ssize_t count = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+                if (count <= 0) return false;
+                written += count;
+            }
+            return true;
+        }
+
+    private:
+        int fd;
+        // Data received after the last line read
+        std::string buffer;
+
+        static bool makeAddress(const std::string &path, sockaddr_un &address)
+        {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) return false;
+            std::strcpy(address.sun_path, path.c_str());
+            return true;
+        }
+
+        // The socket is owned
+        LineSocket(const LineSocket &);
+        LineSocket &operator=(const LineSocket &);
+    };
+}
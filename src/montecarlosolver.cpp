@@ -0,0 +1,276 @@
+#include "montecarlosolver.h"
+#include "bitboard.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace ConnectFour
+{
+    using namespace Bitboards;
+
+    /// @brief Get the next number from an xorshift64* generator.
+    static std::uint64_t nextRandom(std::uint64_t &state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Iterations between checks of the time
+    static const int timeCheckInterval = 64;
+
+    // Games played from a leaf each time it is visited
+    static const int gamesPerVisit = LockstepPlayouts::lanes;
+
+    // Visits a leaf needs, including the current one, before its children are added
+    static const int expandVisits = 2;
+
+    const double MonteCarloSolver::defaultExploration = 1.0;
+
+    MonteCarloSolver::MonteCarloSolver(int maxSolveTime, int threads, int maxNodes) :
+        maxSolveTime(maxSolveTime),
+        threads(threads),
+        maxNodes(maxNodes),
+        exploration(defaultExploration),
+        seed(0x9E3779B97F4A7C15ULL),
+        nodes(maxNodes),
+        nodeCount(0),
+        stopped(false)
+    {
+        assert(maxSolveTime > 0 && threads > 0 && maxNodes > Board::width);
+    }
+
+    void MonteCarloSolver::setExploration(double exploration)
+    {
+        this->exploration = exploration;
+    }
+
+    void MonteCarloSolver::reset()
+    {
+        Node &root = nodes[0];
+        root.visits.store(0, std::memory_order_relaxed);
+        root.score.store(0, std::memory_order_relaxed);
+        root.firstChild.store(children_unexpanded, std::memory_order_relaxed);
+        root.move = -1;
+        root.childCount = 0;
+        root.outcome = -1;
+        nodeCount.store(1, std::memory_order_relaxed);
+        stopped.store(false, std::memory_order_relaxed);
+    }
+
+    int MonteCarloSolver::expand(Node &node, bitboard current, bitboard mask)
+    {
+        const bitboard playable = playableSlots(mask);
+        const bitboard wins = winningSlots(current, mask);
+        const int count = popcount(playable);
+        const int first = nodeCount.fetch_add(count, std::memory_order_relaxed);
+        if (first + count > maxNodes)
+        {
+            return children_none;
+        }
+
+        int index = first;
+        for (int column = 0; column < Board::width; ++column)
+        {
+            const bitboard slot = playable & columnMask(column);
+            if (!slot) continue;
+            Node &child = nodes[index++];
+            child.visits.store(0, std::memory_order_relaxed);
+            child.score.store(0, std::memory_order_relaxed);
+            child.firstChild.store(children_unexpanded, std::memory_order_relaxed);
+            child.move = column;
+            child.childCount = 0;
+            // A move can only end the game by winning it or filling the board
+            child.outcome = (slot & wins) ? 2 : ((mask | slot) == boardMask ? 1 : -1);
+        }
+        node.childCount = count;
+        return first;
+    }
+
+    int MonteCarloSolver::select(const Node &node, int firstChild) const
+    {
+        const double logVisits = std::log(double(node.visits.load(std::memory_order_relaxed)));
+        int best = firstChild;
+        double bestBound = -std::numeric_limits<double>::infinity();
+        for (int i = firstChild; i < firstChild + node.childCount; ++i)
+        {
+            const Node &child = nodes[i];
+            // A winning move is always the best
+            if (child.outcome == 2) return i;
+
+            const int visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0) return i;
+            const double mean = child.score.load(std::memory_order_relaxed) / (2.0 * visits);
+            const double bound = mean + exploration * std::sqrt(logVisits / visits);
+            if (bound > bestBound)
+            {
+                bestBound = bound;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    void MonteCarloSolver::iterate(Search &search)
+    {
+        int path[SearchStatistics::maxPly];
+        int length = 0;
+        bitboard current = search.current;
+        bitboard mask = search.mask;
+
+        int index = 0;
+        int result; // Score of the games for the player to move at the end of the path
+        for (;;)
+        {
+            Node &node = nodes[index];
+            path[length] = index;
+            // Counting the games before their results are known is a virtual loss for the player moving into the node
+            const int visits = (node.visits.fetch_add(gamesPerVisit, std::memory_order_relaxed) + gamesPerVisit) / gamesPerVisit;
+            search.stats.countNode(length);
+            ++length;
+
+            if (node.outcome != -1)
+            {
+                ++search.stats.leafNodes;
+                result = gamesPerVisit * (2 - node.outcome);
+                break;
+            }
+
+            int firstChild = node.firstChild.load(std::memory_order_acquire);
+            if (firstChild == children_unexpanded && visits >= expandVisits)
+            {
+                // Only one thread adds the children, while the others play out from the node
+                if (node.firstChild.compare_exchange_strong(firstChild, children_expanding, std::memory_order_relaxed))
+                {
+                    firstChild = expand(node, current, mask);
+                    node.firstChild.store(firstChild, std::memory_order_release);
+                }
+            }
+            if (firstChild < 0)
+            {
+                ++search.stats.leafNodes;
+                const LockstepPlayouts::Totals totals = search.playouts.play(current, mask, gamesPerVisit);
+                search.stats.playouts += gamesPerVisit;
+                result = static_cast<int>(2*totals.wins + totals.draws);
+                break;
+            }
+
+            ++search.stats.interiorNodes;
+            index = select(node, firstChild);
+            // The other player is now the current player
+            current ^= mask;
+            mask |= playableSlots(mask) & columnMask(nodes[index].move);
+        }
+
+        // Add the result from the leaf back to the root, alternating between the players
+        for (int i = length - 1; i >= 0; --i)
+        {
+            result = 2*gamesPerVisit - result;
+            nodes[path[i]].score.fetch_add(result, std::memory_order_relaxed);
+        }
+    }
+
+    void MonteCarloSolver::searchUntilStopped(Search &search)
+    {
+        const std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(maxSolveTime);
+        while (!stopped.load(std::memory_order_relaxed))
+        {
+            for (int i = 0; i < timeCheckInterval; ++i)
+            {
+                iterate(search);
+            }
+            if (std::chrono::steady_clock::now() >= end)
+            {
+                stopped.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    int MonteCarloSolver::solve(const Board &board)
+    {
+        stats.startSearch();
+        stats.startIteration(0);
+
+        bitboard current, mask;
+        fromBoard(board, current, mask);
+
+        reset();
+        int move = -1, value = 0;
+        if (playableSlots(mask))
+        {
+            // The root is expanded first so that its children exist even if the search is stopped at once
+            Node &root = nodes[0];
+            root.firstChild.store(expand(root, current, mask), std::memory_order_relaxed);
+
+            std::vector<Search> searches(threads);
+            for (int t = 0; t < threads; ++t)
+            {
+                searches[t].current = current;
+                searches[t].mask = mask;
+                // Each thread has its own sequence of random numbers, which differs for each solve
+                seed = nextRandom(seed);
+                searches[t].playouts = LockstepPlayouts(seed | 1);
+            }
+
+            std::vector<std::thread> pool;
+            for (int t = 1; t < threads; ++t)
+            {
+                pool.push_back(std::thread(&MonteCarloSolver::searchUntilStopped, this, std::ref(searches[t])));
+            }
+            searchUntilStopped(searches[0]);
+            for (std::vector<std::thread>::iterator thread = pool.begin(); thread != pool.end(); ++thread)
+            {
+                thread->join();
+            }
+            for (std::vector<Search>::const_iterator search = searches.begin(); search != searches.end(); ++search)
+            {
+                stats.mergeCounts(search->stats);
+            }
+
+            // The most visited move is the one the search is most confident in
+            int mostVisits = -1;
+            const int firstChild = root.firstChild.load(std::memory_order_relaxed);
+            for (int i = firstChild; i < firstChild + root.childCount; ++i)
+            {
+                const Node &child = nodes[i];
+                const int visits = child.visits.load(std::memory_order_relaxed);
+                if (visits > mostVisits)
+                {
+                    mostVisits = visits;
+                    move = child.move;
+                    // Value is the expected score scaled to between -1000 for a loss and 1000 for a win
+                    value = visits > 0 ? (child.score.load(std::memory_order_relaxed) * 1000) / visits - 1000 : 0;
+                }
+            }
+        }
+
+        // The single iteration's height is the deepest ply the tree reached
+        int height = SearchStatistics::maxPly - 1;
+        while (height > 0 && stats.nodesPerPly[height] == 0) --height;
+        stats.iterations.back().height = height;
+        stats.endIteration(move, value);
+        finishStatistics();
+        return move;
+    }
+
+    void MonteCarloSolver::printStatistics(std::ostream &out) const
+    {
+        stats.print(out);
+        out << "Tree nodes: " << std::min(nodeCount.load(std::memory_order_relaxed), maxNodes) << " of " << maxNodes << std::endl;
+        const Node &root = nodes[0];
+        const int firstChild = root.firstChild.load(std::memory_order_relaxed);
+        for (int i = firstChild; firstChild >= 0 && i < firstChild + root.childCount; ++i)
+        {
+            const Node &child = nodes[i];
+            const int visits = child.visits.load(std::memory_order_relaxed);
+            out << "Column " << int(child.move) << ": " << visits << " visits, score "
+                << (visits > 0 ? child.score.load(std::memory_order_relaxed) / (2.0 * visits) : 0) << std::endl;
+        }
+    }
+}
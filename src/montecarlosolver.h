@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "playouts.h"
+#include "solver.h"
+
+namespace ConnectFour
+{
+    /// @class MonteCarloSolver
+    /// @brief Solver for the standard game using Monte Carlo tree search, for play with a time limit.
+    ///
+    /// Children are selected by UCT and each leaf is scored by a batch of random games played in lockstep, so
+    /// visits are counted in games. The tree is built in an arena of nodes allocated when the solver is
+    /// constructed, and stops growing when the arena is full. Several threads can search the same tree: visit
+    /// counts and scores are atomic, and visits are counted on the way down before their results are known, which
+    /// acts as a virtual loss that steers the other threads towards different paths.
+    class MonteCarloSolver : public Solver
+    {
+    public:
+        /// @brief Default number of nodes in the arena: 2^20 - 16MB
+        static const int defaultMaxNodes = 1048576;
+
+        /// @brief Exploration constant for UCT, for scores between 0 and 1.
+        static const double defaultExploration;
+
+        /// @brief Construct a solver.
+        /// @param maxSolveTime The time in milliseconds to search for each move.
+        /// @param threads The number of threads searching the tree together.
+        /// @param maxNodes The number of nodes in the arena.
+        MonteCarloSolver(int maxSolveTime, int threads = 1, int maxNodes = defaultMaxNodes);
+
+        int solve(const Board &board);
+
+        /// @brief Output statistics for the last solve, including the rate of playouts.
+        void printStatistics(std::ostream &out) const;
+
+        /// @brief Set the exploration constant used by UCT.
+        void setExploration(double exploration);
+
+    private:
+        typedef std::uint64_t bitboard;
+
+        // A position in the tree. Scores are in half points for the player who moved into the position: 2 for a
+        // win and 1 for a draw in each game.
+        struct Node
+        {
+            std::atomic<int> visits; // Games played through the position, including those still being played
+            std::atomic<int> score;
+            std::atomic<int> firstChild; // Index of the first child in the arena, or a ChildState if there are none
+            signed char move; // Column played to reach the position
+            signed char childCount;
+            signed char outcome; // Score of every game if the game is over, otherwise -1
+        };
+
+        // Values of Node::firstChild when the children aren't in the arena
+        enum ChildState
+        {
+            children_unexpanded = -1,
+            children_expanding = -2, // Another thread is adding the children
+            children_none = -3 // The arena was full, so the position stays a leaf
+        };
+
+        // Position searched from the root, with the playouts for each thread
+        struct Search
+        {
+            bitboard current;
+            bitboard mask;
+            LockstepPlayouts playouts;
+            SearchStatistics stats;
+        };
+
+        const int maxSolveTime;
+        const int threads;
+        const int maxNodes;
+        double exploration;
+        std::uint64_t seed;
+
+        std::vector<Node> nodes;
+        std::atomic<int> nodeCount;
+        std::atomic<bool> stopped;
+
+        // Clear the tree and set the root
+        void reset();
+
+        // Repeat search iterations until the time is up
+        void searchUntilStopped(Search &search);
+
+        // Select a path from the root, add the children of the leaf if it has been visited before, then score
+        // the leaf with a batch of playouts and add the results to every node on the path
+        void iterate(Search &search);
+
+        // Add the children of a node to the arena for the position with the given pieces
+        // Returns the index of the first child, or children_none if the arena is full
+        int expand(Node &node, bitboard current, bitboard mask);
+
+        // Select the child with the highest upper confidence bound
+        int select(const Node &node, int firstChild) const;
+    };
+}
@@ -0,0 +1,164 @@
+#include "perft.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace ConnectFour
+{
+    // Leaf counts from the empty board, indexed by depth
+    static const long long knownPerftCounts[] =
+        { 1, 7, 49, 343, 2401, 16807, 117649, 823536, 5673234, 39394572, 268031646 };
+    // Distinct positions from the empty board (OEIS A212693), only up to the depth where hash collisions start
+    static const long long knownDistinctCounts[] =
+        { 1, 7, 49, 238, 1120, 4263, 16422, 54859, 184275 };
+
+    /// @brief Hashes of the positions already reached at each ply, shared by every thread when deduplicating.
+    ///        The hashes are split between shards with their own locks, so threads rarely wait for each other.
+    class PerftVisited
+    {
+    public:
+        explicit PerftVisited(int depth) : plies(depth + 1) {}
+
+        /// @brief Add a position at a ply.
+        /// @return Whether it hadn't been reached before.
+        bool insert(int ply, Board::Hash hash)
+        {
+            Shard &shard = plies[ply][hash % shardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.hashes.insert(hash).second;
+        }
+
+    private:
+        static const int shardCount = 64;
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_set<Board::Hash> hashes;
+        };
+
+        std::vector<std::array<Shard, shardCount> > plies;
+    };
+
+    /// @brief State for enumerating a subtree on one thread.
+    struct PerftWorker
+    {
+        int depth;
+        PerftVisited *visited; // Positions reached by any thread, or null if not deduplicating
+        long long leaves;
+        long long wins;
+
+        PerftWorker(int depth, PerftVisited *visited) :
+            depth(depth), visited(visited), leaves(0), wins(0) {}
+
+        /// @brief Count the leaves below a board, which is at the given ply.
+        /// @param won Whether the move to the board won the game.
+        void count(const Board &board, int ply, bool won)
+        {
+            if (visited && !visited->insert(ply, board.getHash()))
+            {
+                // Transposition, the subtree has already been counted
+                return;
+            }
+            if (ply == depth)
+            {
+                ++leaves;
+                return;
+            }
+            if (won)
+            {
+                ++wins;
+                return;
+            }
+
+            for (int column = 0; column < Board::width; ++column)
+            {
+                if (!board.canPlay(column)) continue;
+                Board child(board);
+                child.play(column);
+                bool childWon = child.isWin();
+                child.swap();
+                count(child, ply + 1, childWon);
+            }
+        }
+    };
+
+    PerftResult perft(const Board &board, int depth, bool deduplicate, int threads)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        PerftResult result = {};
+
+        if (depth == 0)
+        {
+            result.leaves = 1;
+            return result;
+        }
+
+        // Root moves are shared out to the threads as they become free
+        std::vector<Board> roots;
+        std::vector<bool> rootsWon;
+        std::vector<int> rootColumns;
+        for (int column = 0; column < Board::width; ++column)
+        {
+            if (!board.canPlay(column)) continue;
+            Board child(board);
+            child.play(column);
+            rootsWon.push_back(child.isWin());
+            child.swap();
+            roots.push_back(child);
+            rootColumns.push_back(column);
+        }
+
+        threads = std::max(1, std::min<int>(threads, roots.size()));
+        // With one set of positions for every thread, each distinct position is counted once by whichever
+        // thread reaches it first, so the totals don't depend on the number of threads
+        std::unique_ptr<PerftVisited> visited(deduplicate ? new PerftVisited(depth) : 0);
+        std::vector<PerftWorker> workers(threads, PerftWorker(depth, visited.get()));
+        std::atomic<size_t> nextRoot(0);
+        std::vector<long long> rootLeaves(roots.size());
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t)
+        {
+            pool.push_back(std::thread([&, t]()
+            {
+                PerftWorker &worker = workers[t];
+                for (size_t root = nextRoot++; root < roots.size(); root = nextRoot++)
+                {
+                    long long before = worker.leaves;
+                    worker.count(roots[root], 1, rootsWon[root]);
+                    rootLeaves[root] = worker.leaves - before;
+                }
+            }));
+        }
+        for (std::vector<std::thread>::iterator thread = pool.begin(); thread != pool.end(); ++thread)
+        {
+            thread->join();
+        }
+
+        for (size_t root = 0; root < roots.size(); ++root)
+        {
+            result.rootLeaves[rootColumns[root]] = rootLeaves[root];
+            result.leaves += rootLeaves[root];
+        }
+        for (int t = 0; t < threads; ++t)
+        {
+            result.wins += workers[t].wins;
+        }
+
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    long long knownPerft(int depth, bool deduplicate)
+    {
+        const long long *counts = deduplicate ? knownDistinctCounts : knownPerftCounts;
+        int known = deduplicate ? sizeof(knownDistinctCounts)/sizeof(*knownDistinctCounts)
+            : sizeof(knownPerftCounts)/sizeof(*knownPerftCounts);
+        return (depth >= 0 && depth < known) ? counts[depth] : -1;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @brief Results of enumerating the move tree from a board.
+    struct PerftResult
+    {
+        long long leaves; // Positions at the requested depth
+        long long wins; // Games won before reaching the requested depth
+        // Leaves below each root move. When deduplicating, a position reached from several root moves is only
+        // counted for the first to reach it, which depends on the order the threads run in.
+        std::array<long long, Board::width> rootLeaves;
+        double milliseconds;
+    };
+
+    /// @brief Count the positions reachable from a board after a number of moves.
+    ///        Moves are generated with Board::canPlay/play, and games that are won aren't continued.
+    /// @param board The board to start from.
+    /// @param depth The number of moves to play.
+    /// @param deduplicate Whether to count only distinct positions and wins, found using the board hash.
+    ///        As hashes may collide this can slightly undercount.
+    /// @param threads The number of threads to split the root moves between.
+    PerftResult perft(const Board &board, int depth, bool deduplicate = false, int threads = 1);
+
+    /// @brief Get the known number of leaves at a depth from the empty board.
+    /// @param deduplicate Whether to get the number of distinct positions.
+    /// @return The number of leaves, or -1 if it isn't known for the depth.
+    long long knownPerft(int depth, bool deduplicate);
+}
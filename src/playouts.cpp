@@ -0,0 +1,209 @@
+#include "playouts.h"
+#include "bitboard.h"
+#include <cassert>
+#include <chrono>
+
+namespace ConnectFour
+{
+    using namespace Bitboards;
+
+    // A bitboard for each lane, with GCC's vector extensions (which Clang also supports), so that the operations
+    // are compiled to SIMD instructions where the target has them. Vectors are only passed by reference, as
+    // passing them by value depends on the instruction set.
+    typedef bitboard laneBitboards __attribute__((vector_size(LockstepPlayouts::lanes * sizeof(bitboard))));
+
+    // The games are compiled for x86 processors with AVX-512 and AVX2 as well as the baseline, to use the widest
+    // vectors available. The functions they call must be inlined into each version to be compiled for it.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(__AVX512F__)
+#define VECTOR_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#define VECTOR_INLINE inline __attribute__((always_inline))
+#else
+#define VECTOR_CLONES
+#define VECTOR_INLINE inline
+#endif
+
+    // Replace each lane with the number of bits set in it. There is no multiply for 64 bit lanes in most SIMD
+    // instruction sets, so the bytes are summed with shifts.
+    static VECTOR_INLINE void countBits(laneBitboards &b)
+    {
+        b = b - ((b >> 1) & 0x5555555555555555ULL);
+        b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+        b = (b + (b >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        b += b >> 8;
+        b += b >> 16;
+        b += b >> 32;
+        b &= 0x7f;
+    }
+
+    // Set each lane of outWon to non-zero if the pieces in that lane connect four, otherwise zero
+    static VECTOR_INLINE void connectsFour(const laneBitboards &pieces, laneBitboards &outWon)
+    {
+        const int shifts[] = { columnBits, 1, columnBits + 1, columnBits - 1 };
+        outWon = laneBitboards();
+        for (int i = 0; i < 4; ++i)
+        {
+            const laneBitboards b = pieces & (pieces >> shifts[i]);
+            outWon |= b & (b >> 2*shifts[i]);
+        }
+    }
+
+    // Set each lane of b to 1 if it is less than a, otherwise 0, for values below 2^63. Unsigned 64 bit comparisons
+    // aren't SIMD instructions before AVX-512, but the sign of the difference is.
+    static VECTOR_INLINE void lessThan(laneBitboards &b, const laneBitboards &a)
+    {
+        b = (b - a) >> 63;
+    }
+
+    double LockstepPlayouts::Totals::gamesPerSecond() const
+    {
+        return (milliseconds > 0) ? (wins + draws + losses) * 1000.0 / milliseconds : 0;
+    }
+
+    LockstepPlayouts::LockstepPlayouts(std::uint64_t seed)
+    {
+        assert(seed != 0);
+        // Spread the seed over the lanes with splitmix64, which never gives 0 for consecutive inputs
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            std::uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            random[lane] = (z ^ (z >> 31)) | 1;
+        }
+    }
+
+    LockstepPlayouts::Totals LockstepPlayouts::play(const Board &board, int count, Game *outGames, int maxLength)
+    {
+        bitboard startCurrent, startMask;
+        fromBoard(board, startCurrent, startMask);
+        return play(startCurrent, startMask, count, outGames, maxLength);
+    }
+
+    VECTOR_CLONES LockstepPlayouts::Totals LockstepPlayouts::play(bitboard startCurrent, bitboard startMask, int count,
+        Game *outGames, int maxLength)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Totals totals = {};
+
+        // Games in each lane, where a lane with no game left keeps playing but isn't recorded
+        laneBitboards current, mask, state, length;
+        int game[lanes];
+        int nextGame = 0, playing = 0;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            current[lane] = startCurrent;
+            mask[lane] = startMask;
+            state[lane] = random[lane];
+            length[lane] = 0;
+            game[lane] = nextGame < count ? nextGame++ : -1;
+            if (game[lane] != -1) ++playing;
+        }
+        if (startMask == boardMask || maxLength <= 0)
+        {
+            // No moves can be played, so every game is a draw without playing
+            for (int i = 0; i < count; ++i)
+            {
+                if (outGames)
+                {
+                    outGames[i].result = 0;
+                    outGames[i].length = 0;
+                }
+            }
+            totals.draws = count;
+            playing = 0;
+        }
+
+        while (playing > 0)
+        {
+            // Lowest empty slot of each column that isn't full
+            laneBitboards playable = (mask + bottom) & boardMask;
+            laneBitboards choice = playable;
+            countBits(choice);
+
+            // Pick a random number below the number of playable columns, which is at most 7, by multiplying 16
+            // random bits by each bit of it
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            const laneBitboards bits = state >> 48;
+            laneBitboards scaled = bits & -(choice & 1);
+            scaled += (bits << 1) & -((choice >> 1) & 1);
+            scaled += (bits << 2) & -((choice >> 2) & 1);
+            choice = scaled >> 16;
+
+            // Clear that many of the lowest playable slots, and play in the lowest that remains
+            for (int i = 0; i < Board::width - 1; ++i)
+            {
+                laneBitboards skip = laneBitboards() + static_cast<bitboard>(i);
+                lessThan(skip, choice);
+                playable ^= playable & -playable & -skip;
+            }
+            const laneBitboards slot = playable & -playable;
+
+            // The player who moved wins if their pieces now connect four, and the other player is now the current player
+            const laneBitboards mover = current | slot;
+            mask |= slot;
+            current = mover ^ mask;
+            laneBitboards won;
+            connectsFour(mover, won);
+            // Non-zero in the lanes where the board is full or the game has reached its length
+            laneBitboards full = mask ^ boardMask;
+            lessThan(full, laneBitboards() + 1);
+            length += 1;
+            laneBitboards limit = laneBitboards() + static_cast<bitboard>(maxLength - 1);
+            lessThan(limit, length);
+            const laneBitboards stopped = won | full | limit;
+
+            if (outGames)
+            {
+                for (int lane = 0; lane < lanes; ++lane)
+                {
+                    if (game[lane] == -1) continue;
+                    // Each column has columnBits bits, so the column is the slot's index divided by that
+                    outGames[game[lane]].moves[length[lane] - 1] =
+                        static_cast<signed char>(__builtin_ctzll(slot[lane]) / columnBits);
+                }
+            }
+
+            // Games usually continue in every lane, which is checked before looking at each lane
+            bitboard anyStopped = 0;
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                anyStopped |= stopped[lane];
+            }
+            if (!anyStopped) continue;
+
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                if (game[lane] == -1 || !stopped[lane]) continue;
+
+                // The player to move at the start moved last after an odd number of moves
+                int result = won[lane] ? ((length[lane] % 2) ? 1 : -1) : 0;
+                if (result > 0) ++totals.wins;
+                else if (result < 0) ++totals.losses;
+                else ++totals.draws;
+                if (outGames)
+                {
+                    outGames[game[lane]].result = result;
+                    outGames[game[lane]].length = static_cast<int>(length[lane]);
+                }
+
+                game[lane] = nextGame < count ? nextGame++ : -1;
+                if (game[lane] == -1) --playing;
+            }
+
+            // Start again from the board in every lane that stopped, with all ones in those lanes of reset
+            const laneBitboards reset = -((-stopped) >> 63);
+            current ^= (current ^ startCurrent) & reset;
+            mask ^= (mask ^ startMask) & reset;
+            length &= ~reset;
+        }
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            random[lane] = state[lane];
+        }
+        totals.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return totals;
+    }
+}
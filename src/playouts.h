@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @class LockstepPlayouts
+    /// @brief Random games of the standard game played in lockstep, with a game in each lane of a vector.
+    ///
+    /// Each step plays a move in every lane at once on column-major bitboards: a uniformly random playable
+    /// column is picked with bit operations instead of retrying full columns, and wins are detected for every
+    /// lane together. Lanes whose games end are given the next game, so the lanes stay busy until the last games.
+    class LockstepPlayouts
+    {
+    public:
+        /// @brief Number of games played at once.
+        static const int lanes = 8;
+
+        /// @brief The most moves a game can have.
+        static const int maxMoves = Board::width*Board::height;
+
+        /// @brief A game played from the starting board.
+        struct Game
+        {
+            int result; // 1 if the player to move on the starting board won, -1 if they lost, otherwise 0
+            int length; // Number of moves played
+            std::array<signed char, maxMoves> moves; // Columns played, starting with the player to move
+        };
+
+        /// @brief Results of a set of games, for the player to move on the starting board.
+        struct Totals
+        {
+            long long wins;
+            long long draws; // Including games stopped before they ended
+            long long losses;
+            double milliseconds;
+
+            /// @brief Get the rate of games played per second.
+            double gamesPerSecond() const;
+        };
+
+        /// @param seed Seed for the random number generator of each lane, which must not be 0.
+        explicit LockstepPlayouts(std::uint64_t seed = 0x9E3779B97F4A7C15ULL);
+
+        /// @brief Play random games from a board.
+        /// @param board Board to start each game from, where neither player has won.
+        /// @param count Number of games to play.
+        /// @param[out] outGames Array to store each game in, or null if only the totals are needed.
+        /// @param maxLength Number of moves after which a game is stopped if it hasn't ended.
+        /// @return The results of the games.
+        Totals play(const Board &board, int count, Game *outGames = 0, int maxLength = maxMoves);
+
+        /// @brief Play random games from a position given as bitboards in the layout of bitboard.h, with bit
+        ///        column*(Board::height + 1) + row set for each piece.
+        /// @param current The pieces of the player to move.
+        /// @param mask Every piece on the board.
+        Totals play(std::uint64_t current, std::uint64_t mask, int count, Game *outGames = 0, int maxLength = maxMoves);
+
+    private:
+        // State of the xorshift generator for each lane
+        std::array<std::uint64_t, lanes> random;
+    };
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include "board.h"
+#include "transpositiontable.h"
+#include "windowtable.h"
+
+namespace ConnectFour
+{
+    /// @brief Rules for the standard game, where a move must be played each turn.
+    struct StandardRules
+    {
+        static const bool allowPass = false;
+        /// @brief Number of moves that may be available, one per column.
+        static const int moveCount = Board::width;
+    };
+
+    /// @brief Rules for the tournament game, where a player may pass instead of playing.
+    ///        The pass is represented by the column Board::width.
+    struct TournamentRules
+    {
+        static const bool allowPass = true;
+        static const int moveCount = Board::width + 1;
+    };
+
+    /// @brief Heuristic evaluation based on the numbers of each type of threat.
+    struct ThreatEvaluation
+    {
+        /// @brief Compute the score for the current player.
+        static int score(const Board &board)
+        {
+            Board::ThreatInfo info = board.getThreatInfo();
+            return 70*(info.allThreats[0] - info.allThreats[1])
+                + 100*(info.groundedThreats[0] - info.groundedThreats[1])
+                + 150*(info.doubleThreats[0] - info.doubleThreats[1]);
+        }
+
+        // The score is computed from the board alone, so there is no state to update for each move
+        static void reset(const Board &) {}
+        static void play(const Board &, int) {}
+        static void undo(const Board &, int) {}
+    };
+
+    /// @brief Heuristic evaluation summing a weight for each window of four slots that only one player has
+    ///        pieces in, by how many pieces they have there. The state of every window is updated incrementally
+    ///        for the moves played and undone, so a leaf is scored from the windows of the last few slots played.
+    ///
+    /// Most children searched are cut by the transposition table before being scored, so moves are only
+    /// recorded when played, and applied to the windows once a board below them is scored.
+    class WindowEvaluation
+    {
+    public:
+        /// @brief Set up the windows for the given board, with its current player as player 0.
+        void reset(const Board &board)
+        {
+            for (int window = 0; window < WindowTable::windowCount; ++window) states[window] = 0;
+            sum = 0;
+            moveCount = 0;
+            appliedCount = 0;
+
+            for (int column = 0; column < Board::width; ++column)
+            {
+                heights[column] = board.getFreeRow(column);
+                for (int row = 0; row < heights[column]; ++row)
+                {
+                    const int bit = (Board::width + 1)*(Board::height - row) - column - 1;
+                    addPiece(board.getPieces(false)[bit] ? 0 : 1, row*Board::width + column);
+                }
+            }
+        }
+
+        /// @brief Record the current player playing in a column, or passing (column Board::width).
+        void play(const Board &, int column)
+        {
+            assert(moveCount < maxMoves);
+            slots[moveCount++] = (column == Board::width) ? -1 : heights[column]++ * Board::width + column;
+        }
+
+        /// @brief Reverse play with the same arguments.
+        void undo(const Board &, int column)
+        {
+            assert(moveCount > 0);
+            --moveCount;
+            if (column != Board::width) --heights[column];
+            if (appliedCount > moveCount)
+            {
+                appliedCount = moveCount;
+                if (slots[moveCount] != -1) removePiece(moveCount % 2, slots[moveCount]);
+            }
+        }
+
+        /// @brief Get the score for the current player of the board reached by the moves played.
+        int score(const Board &)
+        {
+            for (; appliedCount < moveCount; ++appliedCount)
+            {
+                if (slots[appliedCount] != -1) addPiece(appliedCount % 2, slots[appliedCount]);
+            }
+            return (moveCount % 2 == 0) ? sum : -sum;
+        }
+
+    private:
+        // The state of a window is the count of player 0's pieces in it plus 5 times the count of player 1's.
+        // Value of each window state for player 0. A window with pieces of both players can't be connected, and
+        // one with four pieces is a win, so neither is scored.
+        static const int *stateValues()
+        {
+            static const int values[25] = {
+                   0,   10,   30,  100,    0,
+                 -10,    0,    0,    0,    0,
+                 -30,    0,    0,    0,    0,
+                -100,    0,    0,    0,    0,
+                   0,    0,    0,    0,    0,
+            };
+            return values;
+        }
+
+        // A line of play fills each slot at most once, and passes are limited by the search height, which is at
+        // most the number of empty slots
+        static const int maxMoves = 2*Board::width*Board::height;
+
+        // State of every window
+        unsigned char states[WindowTable::windowCount];
+        // Sum of the values of every window for player 0
+        int sum;
+        // Number of pieces in each column, including moves that haven't been applied
+        int heights[Board::width];
+        // Slots played in since the reset, or -1 for a pass. Moves by player 0 are at even indices.
+        int slots[maxMoves];
+        int moveCount;
+        // Number of moves that have been applied to the window states
+        int appliedCount;
+
+        void addPiece(int player, int slot)
+        {
+            const int step = (player == 0) ? 1 : 5;
+            const int *values = stateValues();
+            const unsigned char *windows = WindowTable::slotWindows[slot];
+            for (int i = 0; i < WindowTable::slotWindowCounts[slot]; ++i)
+            {
+                const int state = states[windows[i]];
+                sum += values[state + step] - values[state];
+                states[windows[i]] = static_cast<unsigned char>(state + step);
+            }
+        }
+
+        void removePiece(int player, int slot)
+        {
+            const int step = (player == 0) ? 1 : 5;
+            const int *values = stateValues();
+            const unsigned char *windows = WindowTable::slotWindows[slot];
+            for (int i = 0; i < WindowTable::slotWindowCounts[slot]; ++i)
+            {
+                const int state = states[windows[i]];
+                sum += values[state - step] - values[state];
+                states[windows[i]] = static_cast<unsigned char>(state - step);
+            }
+        }
+    };
+
+    /// @brief Move ordering using values stored in the transposition table from previous iterations,
+    ///        then closeness to the centre column.
+    struct TableOrdering
+    {
+        // Comparison function to sort by descending move value
+        template <std::size_t count>
+        struct MoveCompare
+        {
+            const std::array<int, count> &moveValues;
+            MoveCompare(const std::array<int, count> &values) : moveValues(values) {}
+            bool operator()(int col1, int col2)
+            {
+                if (col1 == -1) return false;
+                if (col2 == -1) return true;
+                return moveValues[col1] > moveValues[col2];
+            }
+        };
+
+        /// @brief Sort the columns to play so that more promising moves appear first.
+        /// @param table The table to find values for each move in.
+        /// @param boards Array of boards for each possible move.
+        /// @param columns Array of columns to play in that should be sorted.
+        template <class Table, std::size_t count>
+        static void orderMoves(const Table &table, const std::array<Board, count> &boards, std::array<int, count> &columns)
+        {
+            // Get values for each move
+            std::array<int, count> moveValues;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                int column = columns[i];
+                if (column != -1)
+                {
+                    const Board &board = boards[column];
+                    const BoardEvaluation eval = table.lookup(board);
+                    if (eval.hash == board.getHash())
+                    {
+                        // Value based on stored value from previous iteration
+                        // Evaluation stored from previous player, so
+                        moveValues[column] = -eval.value;
+                        if (eval.type == evaluation_aboveBeta)
+                        {
+                            // Move was too bad to consider exactly
+                            moveValues[column] -= 10000;
+                        }
+                        else if (eval.type == evaluation_belowAlpha)
+                        {
+                            // Move was too good to consider exactly
+                            moveValues[column] += 10000;
+                        }
+                    }
+                    else
+                    {
+                        moveValues[column] = 0;
+                    }
+
+                    // Adjust value to avoid ties based on closeness to centre position (assume centre is better)
+                    moveValues[column] += 100*((Board::width/2) - std::abs(column - (Board::width/2)));
+                }
+            }
+
+            std::sort(columns.begin(), columns.end(), MoveCompare<count>(moveValues));
+        }
+    };
+}
@@ -0,0 +1,696 @@
+#include "searchsolver.h"
+#include "mainsolver.h"
+#include "tournamentsolver.h"
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <array>
+
+namespace ConnectFour
+{
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    SearchSolver<Rules, Evaluation, Table, Ordering>::SearchSolver(int maxSolveTime, int startDepth, int depthStep, int maxDepth, int tableSize) :
+        maxSolveTime(maxSolveTime),
+        startDepth(startDepth),
+        depthStep(depthStep),
+        maxDepth(maxDepth),
+        outOfTime(false),
+        stopRequested(false),
+        nullMovePruning(false),
+        nullMoveReduction(defaultNullMoveReduction),
+        lateMoveReduction(0),
+        lateMoveFullMoves(defaultLateMoveFullMoves),
+        table(tableSize),
+        keepTable(false),
+        endgameThreshold(Rules::allowPass ? 0 : defaultEndgameThreshold),
+        parityThreshold(Rules::allowPass ? 0 : defaultParityThreshold)
+    {
+        assert(maxSolveTime > 0);
+        assert(startDepth > 0);
+        assert(depthStep > 0);
+        assert(maxDepth == -1 || maxDepth >= startDepth);
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setNullMovePruning(bool enabled, int reduction)
+    {
+        assert(reduction >= 0);
+        nullMovePruning = enabled;
+        nullMoveReduction = reduction;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setLateMoveReductions(int reduction, int fullMoves)
+    {
+        assert(reduction >= 0);
+        assert(fullMoves >= 1);
+        lateMoveReduction = reduction;
+        lateMoveFullMoves = fullMoves;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setEndgameThreshold(int emptySlots)
+    {
+        assert(emptySlots >= 0);
+        endgameThreshold = Rules::allowPass ? 0 : emptySlots;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setParityPruning(int emptySlots)
+    {
+        assert(emptySlots >= 0);
+        parityThreshold = Rules::allowPass ? 0 : emptySlots;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setMaxSolveTime(int milliseconds)
+    {
+        assert(milliseconds > 0);
+        maxSolveTime = milliseconds;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::setKeepTable(bool keep)
+    {
+        keepTable = keep;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::newGame()
+    {
+        table.clear();
+        endgame.clear();
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    bool SearchSolver<Rules, Evaluation, Table, Ordering>::mapTableFile(const std::string &path)
+    {
+        if (!table.mapFile(path)) return false;
+        setKeepTable(true);
+        return true;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::startSolve()
+    {
+        stats.startSearch();
+
+        // Initialise timing
+        endTime = clock::now() + std::chrono::milliseconds(maxSolveTime);
+        outOfTime = stopRequested;
+
+        // Initialise transposition table
+        if (!keepTable) table.clear();
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::solve(const Board &board)
+    {
+        startSolve();
+        evaluation.reset(board);
+
+        // Find the range of heights to iterate
+        int movesToDraw = Board::width*Board::height - board.totalCount();
+        int maxHeight = (maxDepth != -1) ? std::min(maxDepth, movesToDraw) : movesToDraw;
+        int height = std::min(startDepth, maxHeight);
+
+        if (movesToDraw <= endgameThreshold)
+        {
+            // Few enough empty slots to prove the result, recorded as one iteration to the end of the game. It may
+            // take half of the remaining time, leaving the rest for the normal search if it isn't proven by then.
+            stats.startIteration(movesToDraw);
+            EndgameSearch::Result result;
+            const clock::time_point endgameEndTime = endTime - (endTime - clock::now()) / 2;
+            int move = endgame.bestMove(board, &result, stats, endgameEndTime, stopRequested);
+            if (endgame.wasStopped())
+            {
+                stats.endIteration(-1);
+            }
+            else
+            {
+                // Only the result is known, so a win or loss is recorded with the least proven score
+                stats.endIteration(move, result * 10000);
+                if (move != -1 && result != EndgameSearch::result_loss)
+                {
+                    ++stats.endgameSolves;
+                    finishStatistics();
+                    table.saveSnapshot();
+                    return move;
+                }
+            }
+            // Not proven in time, or every move loses, so search normally for the best move, which is the one
+            // that loses latest if every move loses
+            stats.iterations.clear();
+        }
+
+        int value;
+        int move = -1;
+        for (; height <= maxHeight; height += depthStep)
+        {
+            stats.startIteration(height);
+            int newMove = bestMove(board, &value, height, 0, std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max() - 1, false, true);
+            stats.endIteration(newMove, value);
+            if (newMove == -1)
+            {
+                // Ran out of time or no possible moves
+                break;
+            }
+            move = newMove;
+        }
+
+        if (move == -1 && outOfTime && !stopRequested)
+        {
+            // Out of time before the first iteration finished, so take the best move one ply deep, which is quick
+            // enough to search without a time limit
+            outOfTime = false;
+            endTime = clock::time_point::max();
+            stats.startIteration(1);
+            move = bestMove(board, &value, 1, 0, std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max() - 1, false, true);
+            stats.endIteration(move, value);
+        }
+
+        finishStatistics();
+        table.saveSnapshot();
+        return move;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::analyse(const Board &board, AnalysisArray &analysis)
+    {
+        // The table is shared between the searches for every move and every iteration
+        startSolve();
+        evaluation.reset(board);
+
+        int movesToDraw = Board::width*Board::height - board.totalCount();
+        int maxHeight = (maxDepth != -1) ? std::min(maxDepth, movesToDraw) : movesToDraw;
+        int height = std::min(startDepth, maxHeight);
+
+        // Play each move once, moves that win immediately need no search
+        BoardArray boards;
+        std::array<bool, Rules::moveCount> needsSearch;
+        for (int column = 0; column < Rules::moveCount; ++column)
+        {
+            MoveAnalysis &result = analysis[column];
+            result.value = 0;
+            result.height = 0;
+            result.type = evaluation_none;
+            needsSearch[column] = false;
+            if (column == Board::width)
+            {
+                // Pass move
+                boards[column] = board;
+                boards[column].swap();
+                needsSearch[column] = true;
+                continue;
+            }
+            if (!board.canPlay(column)) continue;
+
+            boards[column] = board;
+            boards[column].play(column);
+            if (boards[column].isWin())
+            {
+                result.value = (Board::width*Board::height - board.totalCount() + 1) * 10000;
+                result.height = 1;
+                result.type = evaluation_exact;
+            }
+            else
+            {
+                boards[column].swap();
+                needsSearch[column] = true;
+            }
+        }
+
+        const int minValue = std::numeric_limits<int>::min() + 1;
+        const int maxValue = std::numeric_limits<int>::max() - 1;
+        for (; height > 0 && height <= maxHeight && !outOfTime; height += depthStep)
+        {
+            stats.startIteration(height);
+            for (int column = 0; column < Rules::moveCount && !outOfTime; ++column)
+            {
+                if (!needsSearch[column]) continue;
+                MoveAnalysis &result = analysis[column];
+
+                // Search in a window around the value from the previous iteration unless it is unknown or a win/loss
+                bool aspiration = result.type == evaluation_exact && std::abs(result.value) < 10000;
+                int alpha = aspiration ? result.value - aspirationWindow : minValue;
+                int beta = aspiration ? result.value + aspirationWindow : maxValue;
+
+                int value;
+                // Each move is searched as if it were the best, so each is on a principal variation
+                searchChild(board, boards, column, &value, height - 1, 1, -beta, -alpha, column != Board::width, true);
+                if (outOfTime) break;
+                value = -value;
+
+                if (aspiration && (value <= alpha || value >= beta))
+                {
+                    // The window failed, keep the bound in case the full width search runs out of time
+                    result.value = value;
+                    result.height = height;
+                    result.type = (value <= alpha) ? evaluation_belowAlpha : evaluation_aboveBeta;
+
+                    alpha = minValue;
+                    beta = maxValue;
+                    searchChild(board, boards, column, &value, height - 1, 1, -beta, -alpha, column != Board::width, true);
+                    if (outOfTime) break;
+                    value = -value;
+                }
+
+                // Proven wins and losses are searched again by later iterations too, as a deeper search can find
+                // a faster win than the extensions of a shallower one. Only a value strictly inside the window is
+                // exact, otherwise it is the bound the search was cut off at.
+                result.value = value;
+                result.height = height;
+                result.type = (value <= alpha) ? evaluation_belowAlpha
+                    : ((value >= beta) ? evaluation_aboveBeta : evaluation_exact);
+            }
+            const int best = outOfTime ? -1 : bestAnalysed(analysis);
+            stats.endIteration(best, best != -1 ? analysis[best].value : 0);
+        }
+
+        finishStatistics();
+
+        return bestAnalysed(analysis);
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::quiescence(const Board &board, int depth)
+    {
+        const int emptySlots = Board::width*Board::height - board.totalCount();
+        if (board.getImmediateWins(false).any())
+        {
+            return (emptySlots + 1) * 10000;
+        }
+
+        // The only forcing move is blocking the other player's single immediate threat
+        const Board::bitset threats = board.getImmediateWins(true);
+        if (threats.none() || depth == 0)
+        {
+            return evaluation.score(board);
+        }
+        if (threats.count() > 1)
+        {
+            return -emptySlots * 10000;
+        }
+        if (emptySlots == 1)
+        {
+            // Blocking fills the board
+            return 0;
+        }
+
+        int block = 0;
+        while ((threats & Board::getColumnMask(block)).none()) ++block;
+
+        ++stats.quiescenceNodes;
+        Board child = board;
+        child.play(block);
+        child.swap();
+        evaluation.play(board, block);
+        const int value = -quiescence(child, depth - 1);
+        evaluation.undo(board, block);
+        return value;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::searchChild(const Board &board, const BoardArray &boards, int column, int *outValue, int height, int ply, int alpha, int beta, bool allowNullMove, bool pvNode)
+    {
+        evaluation.play(board, column);
+        int move = bestMove(boards[column], outValue, height, ply, alpha, beta, allowNullMove, pvNode);
+        evaluation.undo(board, column);
+        return move;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::bestAnalysed(const AnalysisArray &analysis)
+    {
+        int move = -1;
+        for (int column = 0; column < Rules::moveCount; ++column)
+        {
+            if (analysis[column].type == evaluation_none) continue;
+            if (move == -1 || analysis[column].value > analysis[move].value)
+            {
+                move = column;
+            }
+        }
+        return move;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::bestMove(const Board &board, int *outValue, int height, int ply, int alpha, int beta, bool allowNullMove, bool pvNode)
+    {
+        // Check whether result is in the transposition table. The root needs a move, which an entry stored for a
+        // leaf of an earlier search (such as a proven win found by quiescence) doesn't have.
+        const BoardEvaluation eval = table.lookup(board);
+        ++stats.tableProbes;
+        const EvaluationType tableType = (eval.hash == board.getHash()) ? usableType(eval, height) : evaluation_none;
+        if (tableType != evaluation_none && (eval.move != -1 || ply != 0))
+        {
+            switch (tableType)
+            {
+            case evaluation_belowAlpha:
+                ++stats.tableHits[SearchStatistics::bound_upper];
+                // Value is an upper bound. Previous player will trim this move unless it is above alpha.
+                if (eval.value <= alpha)
+                {
+                    *outValue = alpha;
+                    return -1;
+                }
+                // The move is known to be no better than the bound, so values above it needn't be distinguished
+                beta = std::min(beta, eval.value + 1);
+                break;
+            case evaluation_aboveBeta:
+                ++stats.tableHits[SearchStatistics::bound_lower];
+                // Value is a lower bound. Possible early beta cutoff.
+                if (eval.value >= beta)
+                {
+                    *outValue = beta;
+                    return eval.move;
+                }
+                // The move is known to be at least as good as the bound
+                alpha = std::max(alpha, eval.value - 1);
+                break;
+            default:
+                ++stats.tableHits[SearchStatistics::bound_exact];
+                // Value is exact and best move is already known.
+                *outValue = eval.value;
+                return eval.move;
+            }
+        }
+
+        stats.countNode(ply);
+
+        // Handle leaf nodes
+        if (height == 0)
+        {
+            ++stats.leafNodes;
+            if (board.totalCount() == Board::width*Board::height)
+            {
+                // Draw (full board)
+                *outValue = 0;
+            }
+            else
+            {
+                // Non-terminal leaf node, use heuristic once there are no forcing moves
+                *outValue = quiescence(board, maxQuiescenceDepth);
+            }
+            storeInTable(board, -1, *outValue, 0, evaluation_exact);
+            return -1;
+        }
+
+        // Mate distance pruning. The best result possible is winning with the next move, and the worst is losing
+        // to the other player's next move, or after passing when the rules allow it. If the window is outside of
+        // those scores then nothing found here can affect the result.
+        const int emptySlots = Board::width*Board::height - board.totalCount();
+        const int bestWin = (emptySlots + 1) * 10000;
+        const int worstLoss = -(Rules::allowPass ? emptySlots + 1 : emptySlots) * 10000;
+        if (bestWin <= alpha || worstLoss >= beta)
+        {
+            ++stats.mateDistanceCutoffs;
+            *outValue = (bestWin <= alpha) ? bestWin : worstLoss;
+            return -1;
+        }
+        alpha = std::max(alpha, worstLoss - 1);
+        beta = std::min(beta, bestWin + 1);
+
+        // Get the boards and columns of moves to explore
+        BoardArray boards;
+        ColumnArray moveOrder;
+        int winningMove = playAllMoves(board, boards, moveOrder);
+        if (winningMove != -1)
+        {
+            ++stats.leafNodes;
+            // Utility function prefers sooner wins
+            *outValue = bestWin;
+            // Return from winning moves without exploring any other moves
+            storeInTable(board, winningMove, *outValue, height, evaluation_exact);
+            return winningMove;
+        }
+        ++stats.interiorNodes;
+
+        // Single reply extension. If the other player could win with their next move, every move other than
+        // blocking it loses, so only the block is searched. It doesn't consume height unless the search would
+        // then extend beyond a filled board.
+        const Board::bitset threats = board.getImmediateWins(true);
+        if (threats.any())
+        {
+            int block = -1;
+            for (int column = 0; column < Board::width && block == -1; ++column)
+            {
+                if ((threats & Board::getColumnMask(column)).any())
+                {
+                    block = column;
+                }
+            }
+
+            if (threats.count() > 1)
+            {
+                // Only one threat can be blocked
+                *outValue = -emptySlots * 10000;
+                storeInTable(board, block, *outValue, height, evaluation_exact);
+                return block;
+            }
+
+            ++stats.singleReplyExtensions;
+            int value;
+            searchChild(board, boards, block, &value, std::min(height, emptySlots - 1), ply + 1, -beta, -alpha, true, pvNode);
+            if (outOfTime) return -1;
+            *outValue = -value;
+            EvaluationType evalType = (*outValue <= alpha) ? evaluation_belowAlpha
+                : ((*outValue >= beta) ? evaluation_aboveBeta : evaluation_exact);
+            storeInTable(board, block, *outValue, height, evalType);
+            return block;
+        }
+
+        // Check whether out of time
+        if ((height % 4) == 0) // TODO Only check the time occasionally
+        {
+            outOfTime = stopRequested || clock::now() >= endTime;
+        }
+
+        // Static zugzwang analysis, once there are no immediate threats left to resolve. The root is always
+        // searched so that a move is found.
+        if (emptySlots <= parityThreshold && ply != 0)
+        {
+            Board::ParityInfo parity = board.getParityInfo();
+            if (parity.controller != -1)
+            {
+                ++stats.parityCutoffs;
+                *outValue = (parity.controller == 0) ? parityScore : -parityScore;
+                // No move is searched, but the entry still needs a playable move for the parent to return and
+                // for move ordering, so the lowest playable column is stored. The moves aren't ordered yet.
+                int playableMove = -1;
+                for (int i = 0; i < Rules::moveCount && playableMove == -1; ++i) playableMove = moveOrder[i];
+                storeInTable(board, playableMove, *outValue, height, evaluation_exact);
+                return playableMove;
+            }
+        }
+
+        // Enhanced transposition cutoff from a child already in the table
+        int cutoffMove = enhancedCutoff(boards, moveOrder, height, beta, outValue);
+        if (cutoffMove != -1)
+        {
+            storeInTable(board, cutoffMove, *outValue, height, evaluation_aboveBeta);
+            return cutoffMove;
+        }
+
+        // Null move pruning. The pass is a legal move, so if passing fails high then the best move would too.
+        // The pass is searched to a reduced depth though, so the cutoff is only taken if a search of this node
+        // to the same reduced depth also fails high. This guards against zugzwang positions, where the reduced
+        // search after a pass misses that the opponent is forced to fill a square below one of our threats.
+        // Nodes on the principal variation are always searched fully, as their values become the result.
+        if (Rules::allowPass && nullMovePruning && allowNullMove && !pvNode && height > nullMoveReduction)
+        {
+            ++stats.nullMoveSearches;
+            int value;
+            searchChild(board, boards, Board::width, &value, height - 1 - nullMoveReduction, ply + 1, -beta, -beta + 1, false);
+            if (outOfTime) return -1;
+            if (-value >= beta)
+            {
+                int verifiedMove = bestMove(board, &value, height - nullMoveReduction, ply, beta - 1, beta, false);
+                if (outOfTime) return -1;
+                if (value >= beta)
+                {
+                    // Not stored in the table, as the value is only known to the reduced height
+                    ++stats.nullMoveCutoffs;
+                    *outValue = value;
+                    return verifiedMove;
+                }
+                ++stats.nullMoveVerifyFailures;
+            }
+        }
+
+        Ordering::orderMoves(table, boards, moveOrder);
+
+        // Compute the move in the next level with best minimax value for the current player
+        int move = -1;
+        *outValue = std::numeric_limits<int>::min();
+        EvaluationType evalType = evaluation_belowAlpha;
+        int threatCount = -1; // Number of threats for the current player, found when first needed
+        for (int i = 0; i < Rules::moveCount; ++i)
+        {
+            int column = moveOrder[i];
+            if (column == -1) continue;
+
+            // Two passes in a row would just return to this position
+            const bool allowChildNullMove = column != Board::width;
+            int value;
+            bool searched = false;
+
+            // Late move reduction
+            if (lateMoveReduction > 0 && i >= lateMoveFullMoves && height > lateMoveReduction)
+            {
+                // Moves that create a threat are tactical, so aren't reduced. The child is from the other
+                // player's perspective, so the current player's threats are its bad threats.
+                if (threatCount == -1) threatCount = board.getThreats(false).count();
+                if (static_cast<int>(boards[column].getThreats(true).count()) <= threatCount)
+                {
+                    ++stats.lateMoveReductions;
+                    searchChild(board, boards, column, &value, height - 1 - lateMoveReduction, ply + 1, -alpha - 1, -alpha, allowChildNullMove);
+                    if (outOfTime) return -1;
+                    // Search fully only if the move may be better than the best so far
+                    searched = -value <= alpha;
+                    if (!searched) ++stats.lateMoveResearches;
+                }
+            }
+
+            if (!searched)
+            {
+                // The first move searched from a principal variation node continues it
+                searchChild(board, boards, column, &value, height - 1, ply + 1, -beta, -alpha, allowChildNullMove, pvNode && move == -1);
+            }
+
+            if (outOfTime)
+            {
+                // Stop searching
+                return -1;
+            }
+
+            // The move is evaluated in terms of the other player, so invert it
+            value = -value;
+
+            // Update maximum
+            if (value > *outValue)
+            {
+                *outValue = value;
+                move = column;
+            }
+
+            // Pruning
+            if (value > alpha)
+            {
+                alpha = value;
+                // value>alpha => -value<-alpha, so value<beta in child. Therefore atleast one child is exact, and
+                // the value returned will be exact unless beta cutoff occurs.
+                evalType = evaluation_exact;
+            }
+            if (alpha >= beta)
+            {
+                // This branch will be too high for the previous player to choose it.
+                // The returned value is not exact, only a lower bound
+                evalType = evaluation_aboveBeta;
+                ++stats.cutoffs;
+                if (i == 0)
+                {
+                    ++stats.firstMoveCutoffs;
+                }
+                break;
+            }
+        }
+
+        storeInTable(board, move, *outValue, height, evalType);
+        return move;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::playAllMoves(const Board &board, BoardArray &boards, ColumnArray &columns)
+    {
+        // Play each column
+        for (int i = 0; i < Board::width; ++i)
+        {
+            if (board.canPlay(i))
+            {
+                columns[i] = i;
+                boards[i] = board;
+                boards[i].play(i);
+                if (boards[i].isWin())
+                {
+                    return i;
+                }
+                boards[i].swap();
+                table.prefetch(boards[i]);
+                ++stats.tablePrefetches;
+            }
+            else
+            {
+                columns[i] = -1;
+            }
+        }
+
+        if (Rules::allowPass)
+        {
+            // Pass move
+            boards[Board::width] = board;
+            boards[Board::width].swap();
+            columns[Board::width] = Board::width;
+            table.prefetch(boards[Board::width]);
+            ++stats.tablePrefetches;
+        }
+
+        return -1;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    EvaluationType SearchSolver<Rules, Evaluation, Table, Ordering>::usableType(const BoardEvaluation &eval, int height)
+    {
+        if (eval.height >= height) return eval.type;
+
+        // Win scores depend only on the number of pieces on the board where the win happens, not the distance
+        // from the root, so proven wins and losses hold for a search of any height. A lower search may not have
+        // found the fastest win though, as the single reply extension follows some lines beyond its height but
+        // not others, so its wins are only lower bounds and its losses upper bounds.
+        if (eval.value >= 10000 && eval.type != evaluation_belowAlpha) return evaluation_aboveBeta;
+        if (eval.value <= -10000 && eval.type != evaluation_aboveBeta) return evaluation_belowAlpha;
+        return evaluation_none;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    int SearchSolver<Rules, Evaluation, Table, Ordering>::enhancedCutoff(const BoardArray &boards, const ColumnArray &columns, int height, int beta, int *outValue)
+    {
+        for (int i = 0; i < Rules::moveCount; ++i)
+        {
+            int column = columns[i];
+            if (column == -1) continue;
+
+            const Board &child = boards[column];
+            const BoardEvaluation eval = table.lookup(child);
+            ++stats.enhancedProbes;
+            // The child's value is for the other player, so an exact value or upper bound for them is a lower
+            // bound for this player
+            const EvaluationType type = (eval.hash == child.getHash()) ? usableType(eval, height - 1) : evaluation_none;
+            if ((type == evaluation_exact || type == evaluation_belowAlpha) && -eval.value >= beta)
+            {
+                ++stats.enhancedCutoffs;
+                *outValue = -eval.value;
+                return column;
+            }
+        }
+        return -1;
+    }
+
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    void SearchSolver<Rules, Evaluation, Table, Ordering>::storeInTable(const Board &board, int move, int value, int height, EvaluationType type)
+    {
+        if (table.store(board, move, value, height, type) == Table::store_replaced)
+        {
+            ++stats.tableReplacements;
+        }
+    }
+
+    // The solver configurations that are used
+    template class SearchSolver<StandardRules, ThreatEvaluation, TranspositionTable, TableOrdering>;
+    template class SearchSolver<TournamentRules, ThreatEvaluation, TranspositionTable, TableOrdering>;
+    template class SearchSolver<StandardRules, WindowEvaluation, TranspositionTable, TableOrdering>;
+    template class SearchSolver<StandardRules, ThreatEvaluation, SharedTranspositionTable, TableOrdering>;
+    template class SearchSolver<TournamentRules, ThreatEvaluation, SharedTranspositionTable, TableOrdering>;
+}
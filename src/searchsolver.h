@@ -0,0 +1,219 @@
+#pragma once
+
+#include <chrono>
+#include <array>
+#include <atomic>
+#include <string>
+#include "solver.h"
+#include "transpositiontable.h"
+#include "sharedtranspositiontable.h"
+#include "searchpolicies.h"
+#include "endgamesearch.h"
+
+namespace ConnectFour
+{
+    /// @class SearchSolver
+    /// @brief Solver using iterative deepening alpha-beta search with a transposition table.
+    ///
+    /// The search is configured at compile time by policies, so unused features cost nothing:
+    /// - Rules: whether a pass move is allowed (StandardRules, TournamentRules).
+    /// - Evaluation: the heuristic score for leaf nodes (ThreatEvaluation, WindowEvaluation). It is told of each
+    ///   move played and undone during the search, so it can keep its score up to date incrementally.
+    /// - Table: the transposition table type (TranspositionTable, or SharedTranspositionTable for solvers on
+    ///   different threads sharing their results).
+    /// - Ordering: how moves are sorted before searching them (TableOrdering).
+    template <class Rules, class Evaluation, class Table, class Ordering>
+    class SearchSolver : public Solver
+    {
+    public:
+        /// @brief  Construct a solver that uses techniques such as iterative deepening, transposition table to improve performance
+        /// @param  targetSolveTime The time in milliseconds that the solver should take to predict the best move.
+        /// @param  startDepth The depth of the search tree in the first iteration
+        /// @param  depthStep The increase in depth after each iteration
+        /// @param  tableSize The number of entries in the transposition table
+        SearchSolver(int maxSolveTime, int startDepth, int depthStep, int maxDepth = -1, int tableSize = Table::defaultSize);
+
+        int solve(const Board &board);
+
+        /// @brief Result of analysing a single move from the root position.
+        struct MoveAnalysis
+        {
+            int value; // Minimax value for the move based on the player making it
+            int height; // Height of the search tree the value was found with
+            EvaluationType type;
+        };
+        typedef std::array<MoveAnalysis, Rules::moveCount> AnalysisArray;
+
+        /// @brief Find the minimax value of every playable move from the given board (multi-PV).
+        ///        Each move is searched with its own window and the transposition table is shared between them.
+        /// @param board Board object representing a board state.
+        /// @param[out] analysis Array to store the analysis for each column in.
+        /// @return Number of the column with the best value, or -1 if no move could be analysed.
+        int analyse(const Board &board, AnalysisArray &analysis);
+
+        /// @brief Enable or disable null move pruning, which only applies when the rules allow a pass.
+        ///        A node is cut when passing and searching to a reduced depth still fails high, and a
+        ///        verification search of the node to the same reduced depth agrees.
+        /// @param enabled Whether to try null move pruning.
+        /// @param reduction The number of plies the searches after a pass are reduced by.
+        void setNullMovePruning(bool enabled, int reduction = defaultNullMoveReduction);
+
+        static const int defaultNullMoveReduction = 2;
+
+        /// @brief Enable or disable late move reductions. Moves ordered after the first few, that don't create a
+        ///        new threat, are searched to a reduced height with a null window, and only searched fully if
+        ///        they beat alpha.
+        /// @param reduction The number of plies late moves are reduced by, or 0 to disable reductions.
+        /// @param fullMoves The number of moves in order that are always searched fully.
+        void setLateMoveReductions(int reduction, int fullMoves = defaultLateMoveFullMoves);
+
+        static const int defaultLateMoveFullMoves = 3;
+
+        /// @brief Set the number of empty slots at which solve switches to an exact win/draw/loss search.
+        ///        This only applies to the standard rules, where a pass can't prolong the game. The exact search
+        ///        may take half the solve time, after which the normal search is used.
+        /// @param emptySlots Boards with at most this many empty slots are solved exactly, or 0 to never switch.
+        void setEndgameThreshold(int emptySlots);
+
+        static const int defaultEndgameThreshold = 20;
+
+        /// @brief Set the number of empty slots at which nodes are scored by threat parity without searching them.
+        ///        When one player controls the zugzwang the node gets a near-proven score of parityScore.
+        ///        This only applies to the standard rules, where the parity of each player's squares is fixed.
+        /// @param emptySlots Boards with at most this many empty slots are scored by parity, or 0 to never.
+        void setParityPruning(int emptySlots);
+
+        static const int defaultParityThreshold = 0;
+
+        /// @brief Set the time in milliseconds that later solves may take.
+        void setMaxSolveTime(int milliseconds);
+
+        /// @brief Set whether the transposition table is kept between solves, so that a solve for a later position
+        ///        in the same game starts with the results of earlier ones. Every entry is still valid, as values
+        ///        depend only on the position they are for.
+        void setKeepTable(bool keep);
+
+        /// @brief Forget the results of previous solves, for the start of a new game.
+        void newGame();
+
+        /// @brief Keep the transposition table in a memory mapped file, so that a solver in a later process starts
+        ///        with the results of this one. A snapshot is saved at the end of each solve, which the next
+        ///        solve marks incomplete again as soon as it changes the table. The table is kept between solves. Only tables of the TranspositionTable type can be mapped.
+        /// @return Whether the file could be mapped.
+        bool mapTableFile(const std::string &path);
+
+        /// @brief Ask a solve running on another thread to finish as soon as possible. The solve returns the move
+        ///        from its last complete iteration. Later solves are stopped immediately until clearStop is called.
+        void stop() { stopRequested = true; }
+
+        /// @brief Allow solves to run again after stop.
+        void clearStop() { stopRequested = false; }
+
+        /// @brief Get the transposition table, for example to share its entries with solvers on other threads.
+        Table &transpositionTable() { return table; }
+
+        /// @brief Score for a position won by zugzwang control, below the scores of proven wins.
+        static const int parityScore = 5000;
+
+        /// @brief The maximum number of forcing moves followed beyond the leaves of the search tree.
+        static const int maxQuiescenceDepth = 8;
+
+    private:
+        typedef std::array<Board, Rules::moveCount> BoardArray;
+        typedef std::array<int, Rules::moveCount> ColumnArray;
+
+        int maxSolveTime;
+
+        // Search depth parameters
+        const int startDepth;
+        const int depthStep;
+        const int maxDepth;
+
+        // The time to end computation at. Wall clock time is used so that solvers on different threads each get
+        // their full time.
+        typedef std::chrono::steady_clock clock;
+        clock::time_point endTime;
+        // Whether to complete computation as soon as possible
+        bool outOfTime;
+        // Set by another thread to end the solve early
+        std::atomic<bool> stopRequested;
+
+        // Half width of the window searched around a move's value from the previous iteration in analyse
+        static const int aspirationWindow = 500;
+
+        // Null move pruning parameters
+        bool nullMovePruning;
+        int nullMoveReduction;
+
+        // Late move reduction parameters
+        int lateMoveReduction;
+        int lateMoveFullMoves;
+
+        // Transposition table, and whether it is kept between solves
+        Table table;
+        bool keepTable;
+
+        // Heuristic evaluation, following the moves of the search from the root
+        Evaluation evaluation;
+
+        // Exact search for the end of the game. Its table is kept between solves.
+        EndgameSearch endgame;
+        int endgameThreshold;
+
+        // Empty slots at which threat parity is used to score nodes
+        int parityThreshold;
+
+        /// @brief Get the best move and minimax value for the given board
+        /// @param board A board position.
+        /// @param[out] outValue Pointer to integer to write minimax value to.
+        /// @param height The maximum height for the search tree. Must not extend beyond a filled board.
+        /// @param ply The number of moves played from the root to reach the board, 0 at the root.
+        /// @param alpha Lower bound for value to search for.
+        /// @param beta Upper board for value to search for.
+        /// @param allowNullMove Whether null move pruning may be tried, false at the root and after a pass.
+        /// @param pvNode Whether the node is on the principal variation: the root, or the first move searched from
+        ///        a node on it. Null move pruning is never tried on it.
+        /// @return The move to take from the given board, or -1 if no move was determined.
+        int bestMove(const Board &board, int *outValue, int height, int ply, int alpha, int beta, bool allowNullMove = true, bool pvNode = false);
+
+        /// @brief Search a child of a board with bestMove, updating the evaluation for the move to it.
+        /// @param board The parent board.
+        /// @param boards Array of the boards resulting from each move, from playAllMoves.
+        /// @param column The move to search the child of.
+        /// @param ply The ply of the child.
+        int searchChild(const Board &board, const BoardArray &boards, int column, int *outValue, int height, int ply, int alpha, int beta, bool allowNullMove = true, bool pvNode = false);
+
+        /// @brief Get the value of a leaf node, following forcing moves before applying the evaluation so that
+        ///        pending wins and blocks are resolved.
+        /// @param board A board position that isn't full.
+        /// @param depth The maximum number of forcing moves to follow.
+        /// @return The value for the current player.
+        int quiescence(const Board &board, int depth);
+
+        /// @brief Get the column with the best value from an analysis, or -1 if no column was analysed.
+        static int bestAnalysed(const AnalysisArray &analysis);
+
+        /// @brief Reset the statistics, timing and table (unless it is kept) for a new solve.
+        void startSolve();
+
+        /// @brief Play each playable column, and pass if the rules allow it.
+        ///        The table entries for the resulting boards are prefetched, as they are read for move ordering.
+        /// @param[out] boards Array to store the resulting boards for move in each column
+        /// @param[out] columns Array to store column numbers of moves to explore
+        /// @return Column for a move resulting in a win, or -1 if there is none.
+        int playAllMoves(const Board &board, BoardArray &boards, ColumnArray &columns);
+
+        /// @brief Get how a table entry can be used for a search of the given height. Entries from searches at
+        ///        least as high keep their type, and proven wins and losses from lower searches are bounds.
+        /// @return The type of the entry's value for the search, or evaluation_none if it can't be used.
+        static EvaluationType usableType(const BoardEvaluation &eval, int height);
+
+        /// @brief Check whether a child's table entry already proves a beta cutoff, without searching it.
+        /// @param[out] outValue Pointer to integer to write the proven lower bound to.
+        /// @return The column of the move causing the cutoff, or -1 if there is none.
+        int enhancedCutoff(const BoardArray &boards, const ColumnArray &columns, int height, int beta, int *outValue);
+
+        /// @breif Store a board evaluation in the transposition table.
+        void storeInTable(const Board &board, int move, int value, int height, EvaluationType type);
+    };
+}
@@ -0,0 +1,101 @@
+#include "sharedtranspositiontable.h"
+#include <cassert>
+
+namespace ConnectFour
+{
+    // Data word layout: value in bits 0-31, height in bits 32-39, move + 1 in bits 40-43, type in bits 44-45
+    static const int heightShift = 32;
+    static const int moveShift = 40;
+    static const int typeShift = 44;
+
+    const SharedTranspositionTable::StoreResult SharedTranspositionTable::store_new;
+    const SharedTranspositionTable::StoreResult SharedTranspositionTable::store_replaced;
+
+    SharedTranspositionTable::Storage::Storage(int size) :
+        size(size),
+        buckets(size / bucketSize),
+        words(new Word[2 * size])
+    {
+        assert(size >= bucketSize && size % bucketSize == 0);
+        for (int i = 0; i < 2 * size; ++i)
+        {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SharedTranspositionTable::SharedTranspositionTable(int size) :
+        storage(std::make_shared<Storage>(size))
+    {
+    }
+
+    void SharedTranspositionTable::share(const SharedTranspositionTable &other)
+    {
+        storage = other.storage;
+    }
+
+    int SharedTranspositionTable::getSize() const
+    {
+        return storage->size;
+    }
+
+    void SharedTranspositionTable::clear()
+    {
+        for (int i = 0; i < 2 * storage->size; ++i)
+        {
+            storage->words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t SharedTranspositionTable::pack(int move, int value, int height, EvaluationType type)
+    {
+        assert(move >= -1 && move <= Board::width);
+        assert(height >= 0 && height < 256);
+        assert(type >= evaluation_exact && type <= evaluation_aboveBeta);
+        return static_cast<std::uint32_t>(value)
+            | (static_cast<std::uint64_t>(height) << heightShift)
+            | (static_cast<std::uint64_t>(move + 1) << moveShift)
+            | (static_cast<std::uint64_t>(type) << typeShift);
+    }
+
+    BoardEvaluation SharedTranspositionTable::unpack(const Word *entry, Board::Hash expectedHash)
+    {
+        const std::uint64_t key = entry[0].load(std::memory_order_relaxed);
+        const std::uint64_t data = entry[1].load(std::memory_order_relaxed);
+
+        BoardEvaluation eval;
+        // The key is only the hash xor the data if both words are from the same store
+        const std::uint64_t hash = key ^ data;
+        eval.hash = (hash >> 32) == 0 ? static_cast<Board::Hash>(hash) : ~expectedHash;
+        eval.value = static_cast<int>(static_cast<std::uint32_t>(data));
+        eval.height = static_cast<int>((data >> heightShift) & 0xff);
+        eval.move = static_cast<int>((data >> moveShift) & 0xf) - 1;
+        eval.type = static_cast<EvaluationType>((data >> typeShift) & 0x3);
+        return eval;
+    }
+
+    BoardEvaluation SharedTranspositionTable::lookup(const Board &board) const
+    {
+        const Word *bucket = bucketFor(board);
+        BoardEvaluation eval = unpack(&bucket[0], board.getHash());
+        if (eval.hash != board.getHash())
+        {
+            BoardEvaluation second = unpack(&bucket[2], board.getHash());
+            if (second.hash == board.getHash()) return second;
+        }
+        return eval;
+    }
+
+    SharedTranspositionTable::StoreResult SharedTranspositionTable::store(const Board &board, int move, int value, int height, EvaluationType type)
+    {
+        Word *bucket = const_cast<Word *>(bucketFor(board));
+        const BoardEvaluation first = unpack(&bucket[0], board.getHash());
+        Word *entry = (height >= first.height || first.hash == board.getHash()) ? &bucket[0] : &bucket[2];
+
+        StoreResult result = (entry[0].load(std::memory_order_relaxed) == 0 && entry[1].load(std::memory_order_relaxed) == 0)
+            ? store_new : store_replaced;
+        const std::uint64_t data = pack(move, value, height, type);
+        entry[0].store(board.getHash() ^ data, std::memory_order_relaxed);
+        entry[1].store(data, std::memory_order_relaxed);
+        return result;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "board.h"
+#include "transpositiontable.h"
+
+namespace ConnectFour
+{
+    /// @class SharedTranspositionTable
+    /// @brief Transposition table that can be shared by solvers searching on different threads, without locks.
+    ///
+    /// Each entry is packed into a data word, and stored with a key word holding the board hash xor the data.
+    /// A thread can read the two words while another writes them, so the hash is only recovered from an entry
+    /// that was written whole, and a torn entry is just a miss. Entries are replaced with the same two entry
+    /// bucket policy as TranspositionTable.
+    class SharedTranspositionTable
+    {
+    public:
+        /// @brief Default number of entries: 2^18 - 4MB
+        static const int defaultSize = TranspositionTable::defaultSize;
+
+        /// @brief Number of entries in each bucket.
+        static const int bucketSize = 2;
+
+        typedef TranspositionTable::StoreResult StoreResult;
+        static const StoreResult store_new = TranspositionTable::store_new;
+        static const StoreResult store_replaced = TranspositionTable::store_replaced;
+
+        /// @brief Construct a table with its own entries.
+        explicit SharedTranspositionTable(int size = defaultSize);
+
+        /// @brief Use the entries of another table, which are kept until every table using them is destroyed.
+        void share(const SharedTranspositionTable &other);
+
+        /// @brief Get the number of entries.
+        int getSize() const;
+
+        /// @brief Remove all evaluations from the table. Other threads must not be using it.
+        void clear();
+
+        /// @brief Shared tables are never kept in a file, so that the same interface as TranspositionTable can be
+        ///        used by the solvers.
+        /// @return Always false.
+        bool mapFile(const std::string &) { return false; }
+
+        /// @brief Does nothing, as no file is ever mapped.
+        void saveSnapshot() {}
+
+        /// @brief Get a copy of the table entry for the given board, which is for a different board unless its
+        ///        hash matches.
+        BoardEvaluation lookup(const Board &board) const;
+
+        /// @brief Hint that the entry for the given board will be read soon, so that it can be loaded into the cache.
+        void prefetch(const Board &board) const
+        {
+#ifdef __GNUC__
+            __builtin_prefetch(bucketFor(board));
+#endif
+        }
+
+        /// @brief Store a board evaluation in the depth preferred entry if it is at least as high, or is for the
+        ///        same board, otherwise in the always replaced entry.
+        StoreResult store(const Board &board, int move, int value, int height, EvaluationType type);
+
+    private:
+        typedef std::atomic<std::uint64_t> Word;
+
+        // Entries shared between tables, each a key word followed by a data word
+        struct Storage
+        {
+            explicit Storage(int size);
+
+            const int size;
+            const int buckets;
+            std::unique_ptr<Word[]> words;
+        };
+
+        std::shared_ptr<Storage> storage;
+
+        const Word *bucketFor(const Board &board) const
+            { return &storage->words[(board.getHash() % storage->buckets) * bucketSize * 2]; }
+
+        /// @brief Pack the fields of an evaluation other than the hash into a data word.
+        static std::uint64_t pack(int move, int value, int height, EvaluationType type);
+
+        /// @brief Read the entry at the given words into an evaluation, with a hash that doesn't match any
+        ///        board if it was torn.
+        static BoardEvaluation unpack(const Word *entry, Board::Hash expectedHash);
+    };
+}
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include "board.h"
+#include "statistics.h"
 
 namespace ConnectFour
 {
@@ -17,11 +18,44 @@ namespace ConnectFour
         /// @return Number of the column for the move found, or -1 if no move could be found.
         virtual int solve(const Board &board) = 0;
 
-        /// @brief Gets statistics for the last solve if they have been recorded.
-        /// @return A string describing the statistics, or empty string if no statistics are recorded.
-        virtual void printStatistics(std::ostream &out) const = 0;
+        /// @brief Output statistics for the last solve in a human readable form.
+        virtual void printStatistics(std::ostream &out) const { stats.print(out); }
+
+        /// @brief Gets statistics for the last solve.
+        const SearchStatistics &statistics() const { return stats; }
+
+        /// @brief Gets statistics totalled over every solve.
+        const SearchStatistics &totalStatistics() const { return totals; }
+
+        /// @brief Gets the move to play for the result of a solve, which is the move found unless the solve failed.
+        /// @param board The board that was solved.
+        /// @param move The result of solve, or -1 if it failed.
+        /// @return The move, or for a failed solve the playable column closest to the centre, or Board::width
+        ///         (pass) if every column is full.
+        static int moveToPlay(const Board &board, int move)
+        {
+            if (move != -1) return move;
+            for (int offset = 0; offset <= Board::width/2; ++offset)
+            {
+                if (board.canPlay(Board::width/2 - offset)) return Board::width/2 - offset;
+                if (board.canPlay(Board::width/2 + offset)) return Board::width/2 + offset;
+            }
+            return Board::width;
+        }
 
     protected:
         Solver() {};
+
+        // Statistics for the last solve, updated directly by the search
+        SearchStatistics stats;
+        // Statistics totalled over all solves
+        SearchStatistics totals;
+
+        /// @brief Finish recording statistics for a solve, adding them to the totals.
+        void finishStatistics()
+        {
+            stats.endSearch();
+            totals.merge(stats);
+        }
     };
 }
@@ -0,0 +1,261 @@
+#include "statistics.h"
+#include <cmath>
+
+namespace ConnectFour
+{
+    void SearchStatistics::reset()
+    {
+        nodes = 0;
+        leafNodes = 0;
+        quiescenceNodes = 0;
+        interiorNodes = 0;
+        nodesPerPly.fill(0);
+        tableProbes = 0;
+        tableHits.fill(0);
+        tableReplacements = 0;
+        tablePrefetches = 0;
+        enhancedProbes = 0;
+        enhancedCutoffs = 0;
+        cutoffs = 0;
+        firstMoveCutoffs = 0;
+        mateDistanceCutoffs = 0;
+        singleReplyExtensions = 0;
+        lateMoveReductions = 0;
+        lateMoveResearches = 0;
+        parityCutoffs = 0;
+        endgameNodes = 0;
+        endgameTableHits = 0;
+        endgameSolves = 0;
+        nullMoveSearches = 0;
+        nullMoveCutoffs = 0;
+        nullMoveVerifyFailures = 0;
+        playouts = 0;
+        iterations.clear();
+        bestMoveChanges = 0;
+        milliseconds = 0;
+        searches = 0;
+        iterationStartNodes = 0;
+    }
+
+    void SearchStatistics::merge(const SearchStatistics &other)
+    {
+        mergeCounts(other);
+        // Iterations aren't combined, only the most recent search's are kept
+        iterations = other.iterations;
+        bestMoveChanges += other.bestMoveChanges;
+        milliseconds += other.milliseconds;
+        searches += other.searches;
+    }
+
+    void SearchStatistics::mergeCounts(const SearchStatistics &other)
+    {
+        nodes += other.nodes;
+        leafNodes += other.leafNodes;
+        quiescenceNodes += other.quiescenceNodes;
+        interiorNodes += other.interiorNodes;
+        for (int i = 0; i < maxPly; ++i)
+        {
+            nodesPerPly[i] += other.nodesPerPly[i];
+        }
+        tableProbes += other.tableProbes;
+        for (int i = 0; i < boundTypes; ++i)
+        {
+            tableHits[i] += other.tableHits[i];
+        }
+        tableReplacements += other.tableReplacements;
+        tablePrefetches += other.tablePrefetches;
+        enhancedProbes += other.enhancedProbes;
+        enhancedCutoffs += other.enhancedCutoffs;
+        cutoffs += other.cutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        mateDistanceCutoffs += other.mateDistanceCutoffs;
+        singleReplyExtensions += other.singleReplyExtensions;
+        lateMoveReductions += other.lateMoveReductions;
+        lateMoveResearches += other.lateMoveResearches;
+        parityCutoffs += other.parityCutoffs;
+        endgameNodes += other.endgameNodes;
+        endgameTableHits += other.endgameTableHits;
+        endgameSolves += other.endgameSolves;
+        nullMoveSearches += other.nullMoveSearches;
+        nullMoveCutoffs += other.nullMoveCutoffs;
+        nullMoveVerifyFailures += other.nullMoveVerifyFailures;
+        playouts += other.playouts;
+    }
+
+    void SearchStatistics::startSearch()
+    {
+        reset();
+        searches = 1;
+        searchStart = clock::now();
+    }
+
+    void SearchStatistics::endSearch()
+    {
+        milliseconds = millisecondsSince(searchStart);
+    }
+
+    void SearchStatistics::startIteration(int height)
+    {
+        Iteration iteration = {};
+        iteration.height = height;
+        iteration.move = -1;
+        iterations.push_back(iteration);
+        iterationStartNodes = nodes;
+        iterationStart = clock::now();
+    }
+
+    void SearchStatistics::endIteration(int move, int value)
+    {
+        Iteration &iteration = iterations.back();
+        iteration.move = move;
+        iteration.value = (move != -1) ? value : 0;
+        iteration.nodes = nodes - iterationStartNodes;
+        iteration.milliseconds = millisecondsSince(iterationStart);
+
+        if (move != -1 && iterations.size() > 1)
+        {
+            int previousMove = iterations[iterations.size() - 2].move;
+            if (previousMove != -1 && previousMove != move)
+            {
+                ++bestMoveChanges;
+            }
+        }
+
+        // Branching factor is the growth in nodes from the previous iteration, or the average for the first
+        if (iterations.size() > 1 && iterations[iterations.size() - 2].nodes > 0)
+        {
+            iteration.branchingFactor = double(iteration.nodes) / iterations[iterations.size() - 2].nodes;
+        }
+        else if (iteration.height > 0)
+        {
+            iteration.branchingFactor = std::pow(double(iteration.nodes), 1.0 / iteration.height);
+        }
+        else
+        {
+            iteration.branchingFactor = 0;
+        }
+    }
+
+    double SearchStatistics::nodesPerSecond() const
+    {
+        return (milliseconds > 0) ? nodes * 1000.0 / milliseconds : 0;
+    }
+
+    double SearchStatistics::firstMoveCutoffRate() const
+    {
+        return (cutoffs > 0) ? double(firstMoveCutoffs) / cutoffs : 0;
+    }
+
+    double SearchStatistics::playoutsPerSecond() const
+    {
+        return (milliseconds > 0) ? playouts * 1000.0 / milliseconds : 0;
+    }
+
+    void SearchStatistics::print(std::ostream &out) const
+    {
+        out << "Nodes examined: " << nodes << " (" << leafNodes << " leaf, " << interiorNodes << " interior), "
+                << quiescenceNodes << " quiescence" << std::endl
+            << "Table hit/replace: " << (tableHits[bound_exact] + tableHits[bound_upper] + tableHits[bound_lower])
+                << "/" << tableReplacements << std::endl
+            << "Table hits exact/upper/lower: " << tableHits[bound_exact] << "/" << tableHits[bound_upper]
+                << "/" << tableHits[bound_lower] << " of " << tableProbes << " probes" << std::endl
+            << "Enhanced transposition cutoffs: " << enhancedCutoffs << " from " << enhancedProbes << " child probes, "
+                << tablePrefetches << " prefetches" << std::endl
+            << "Cutoffs: " << cutoffs << " (" << (100 * firstMoveCutoffRate()) << "% by first move)" << std::endl
+            << "Mate distance cutoffs: " << mateDistanceCutoffs << ", single reply extensions: " << singleReplyExtensions << std::endl
+            << "Late move reductions: " << lateMoveReductions << ", " << lateMoveResearches << " searched again" << std::endl
+            << "Parity cutoffs: " << parityCutoffs << std::endl;
+        if (endgameNodes > 0)
+        {
+            out << "Endgame search: " << endgameNodes << " nodes, " << endgameTableHits << " table hits, "
+                << endgameSolves << " search(es) solved" << std::endl;
+        }
+        if (nullMoveSearches > 0)
+        {
+            out << "Null moves: " << nullMoveSearches << " searched, " << nullMoveCutoffs << " cutoffs, "
+                << nullMoveVerifyFailures << " failed verification" << std::endl;
+        }
+        if (playouts > 0)
+        {
+            out << "Playouts: " << playouts << ", " << static_cast<long long>(playoutsPerSecond()) << " playouts/s" << std::endl;
+        }
+        out << "Time: " << milliseconds << " ms over " << searches << " search(es), "
+                << static_cast<long long>(nodesPerSecond()) << " nodes/s" << std::endl;
+        out << "Best move changes between iterations: " << bestMoveChanges << std::endl;
+
+        out << "Nodes per ply:";
+        int lastPly = maxPly - 1;
+        while (lastPly > 0 && nodesPerPly[lastPly] == 0) --lastPly;
+        for (int ply = 0; ply <= lastPly; ++ply)
+        {
+            out << " " << nodesPerPly[ply];
+        }
+        out << std::endl;
+
+        for (std::vector<Iteration>::const_iterator i = iterations.begin(); i != iterations.end(); ++i)
+        {
+            out << "Iteration height " << i->height << ": move " << i->move << ", value " << i->value << ", " << i->nodes << " nodes, "
+                << i->milliseconds << " ms, branching factor " << i->branchingFactor << std::endl;
+        }
+    }
+
+    void SearchStatistics::printJson(std::ostream &out) const
+    {
+        out << "{\"nodes\":" << nodes
+            << ",\"leafNodes\":" << leafNodes
+            << ",\"interiorNodes\":" << interiorNodes
+            << ",\"quiescenceNodes\":" << quiescenceNodes
+            << ",\"nodesPerPly\":[";
+        int lastPly = maxPly - 1;
+        while (lastPly > 0 && nodesPerPly[lastPly] == 0) --lastPly;
+        for (int ply = 0; ply <= lastPly; ++ply)
+        {
+            out << (ply ? "," : "") << nodesPerPly[ply];
+        }
+        out << "],\"tableProbes\":" << tableProbes
+            << ",\"tableHits\":{\"exact\":" << tableHits[bound_exact]
+                << ",\"upper\":" << tableHits[bound_upper]
+                << ",\"lower\":" << tableHits[bound_lower] << "}"
+            << ",\"tableReplacements\":" << tableReplacements
+            << ",\"tablePrefetches\":" << tablePrefetches
+            << ",\"enhancedProbes\":" << enhancedProbes
+            << ",\"enhancedCutoffs\":" << enhancedCutoffs
+            << ",\"cutoffs\":" << cutoffs
+            << ",\"firstMoveCutoffs\":" << firstMoveCutoffs
+            << ",\"firstMoveCutoffRate\":" << firstMoveCutoffRate()
+            << ",\"mateDistanceCutoffs\":" << mateDistanceCutoffs
+            << ",\"singleReplyExtensions\":" << singleReplyExtensions
+            << ",\"lateMoveReductions\":" << lateMoveReductions
+            << ",\"lateMoveResearches\":" << lateMoveResearches
+            << ",\"parityCutoffs\":" << parityCutoffs
+            << ",\"endgameNodes\":" << endgameNodes
+            << ",\"endgameTableHits\":" << endgameTableHits
+            << ",\"endgameSolves\":" << endgameSolves
+            << ",\"nullMoveSearches\":" << nullMoveSearches
+            << ",\"nullMoveCutoffs\":" << nullMoveCutoffs
+            << ",\"nullMoveVerifyFailures\":" << nullMoveVerifyFailures
+            << ",\"playouts\":" << playouts
+            << ",\"playoutsPerSecond\":" << playoutsPerSecond()
+            << ",\"milliseconds\":" << milliseconds
+            << ",\"searches\":" << searches
+            << ",\"bestMoveChanges\":" << bestMoveChanges
+            << ",\"nodesPerSecond\":" << nodesPerSecond()
+            << ",\"iterations\":[";
+        for (std::vector<Iteration>::const_iterator i = iterations.begin(); i != iterations.end(); ++i)
+        {
+            out << (i == iterations.begin() ? "" : ",")
+                << "{\"height\":" << i->height
+                << ",\"move\":" << i->move
+                << ",\"value\":" << i->value
+                << ",\"nodes\":" << i->nodes
+                << ",\"milliseconds\":" << i->milliseconds
+                << ",\"branchingFactor\":" << i->branchingFactor << "}";
+        }
+        out << "]}" << std::endl;
+    }
+
+    double SearchStatistics::millisecondsSince(clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @class SearchStatistics
+    /// @brief Counters recorded by a solver while searching.
+    ///
+    /// Counters are plain integers that are incremented directly by the search, so recording them is always
+    /// enabled. Timing is only taken at the start and end of each search iteration.
+    class SearchStatistics
+    {
+    public:
+        /// @brief The number of plies from the root that nodes are counted for.
+        static const int maxPly = Board::width*Board::height + 2;
+
+        /// @brief Types of transposition table entries, indexing the tableHits array.
+        enum BoundType
+        {
+            bound_exact,
+            bound_upper,
+            bound_lower,
+            boundTypes
+        };
+
+        /// @brief Statistics for a single iteration of iterative deepening.
+        struct Iteration
+        {
+            int height; // Height of the search tree
+            int move; // Best move found by the iteration, or -1 if it didn't complete
+            int value; // Value of the best move for the current player, if the iteration completed
+            long long nodes; // Nodes examined during the iteration
+            double milliseconds; // Wall clock time taken by the iteration
+            double branchingFactor; // Effective branching factor
+        };
+
+        SearchStatistics() { reset(); }
+
+        long long nodes; // Nodes examined
+        long long leafNodes; // Nodes evaluated without expanding children
+        long long quiescenceNodes; // Nodes beyond the leaves along forcing moves
+        long long interiorNodes; // Nodes with children searched
+        std::array<long long, maxPly> nodesPerPly; // Nodes examined at each ply from the root
+
+        long long tableProbes; // Times the transposition table was searched for a position
+        std::array<long long, boundTypes> tableHits; // Times a required position was in the table, by type
+        long long tableReplacements; // Collisions where old value was replaced
+        long long tablePrefetches; // Child table entries prefetched when a node was expanded
+        long long enhancedProbes; // Child table entries checked for an enhanced transposition cutoff
+        long long enhancedCutoffs; // Beta cutoffs from a child's table entry without searching it
+
+        long long cutoffs; // Beta cutoffs at interior nodes
+        long long firstMoveCutoffs; // Beta cutoffs caused by the first move searched
+        long long mateDistanceCutoffs; // Nodes cut because no win or loss from them could change the result
+        long long singleReplyExtensions; // Forced blocks searched without consuming height
+        long long lateMoveReductions; // Late moves searched to a reduced height
+        long long lateMoveResearches; // Reduced moves that beat alpha and were searched again fully
+        long long parityCutoffs; // Nodes scored by threat parity without searching them
+
+        long long endgameNodes; // Nodes examined by the exact endgame search, which are also counted in nodes
+        long long endgameTableHits; // Times the endgame table had bounds for a position
+        int endgameSolves; // Searches answered by the exact endgame search
+
+        long long nullMoveSearches; // Reduced depth searches after a pass to try null move pruning
+        long long nullMoveCutoffs; // Nodes cut because a pass failed high and the verification search agreed
+        long long nullMoveVerifyFailures; // Passes that failed high but the verification search didn't
+
+        long long playouts; // Random games played to the end to score a leaf
+
+        std::vector<Iteration> iterations;
+        int bestMoveChanges; // Iterations that found a different move to the previous iteration
+        double milliseconds; // Wall clock time for the whole search
+        int searches; // Number of searches the statistics cover
+
+        /// @brief Clear all of the statistics.
+        void reset();
+
+        /// @brief Add the statistics from another set, such as to keep totals over many searches.
+        void merge(const SearchStatistics &other);
+        /// @brief Add only the node and event counts from another set, such as from part of the current search
+        ///        that was searched on another thread.
+        void mergeCounts(const SearchStatistics &other);
+
+        /// @brief Record a node at the given ply from the root.
+        void countNode(int ply)
+        {
+            ++nodes;
+            ++nodesPerPly[ply < maxPly ? ply : maxPly - 1];
+        }
+
+        /// @brief Start timing a new search.
+        void startSearch();
+        /// @brief Finish timing the current search.
+        void endSearch();
+        /// @brief Start timing a search iteration with the given height.
+        void startIteration(int height);
+        /// @brief Finish timing the current iteration.
+        /// @param move The move found by the iteration, or -1 if it didn't complete.
+        /// @param value The value of the move for the current player.
+        void endIteration(int move, int value = 0);
+
+        /// @brief Get the rate of nodes examined per second.
+        double nodesPerSecond() const;
+        /// @brief Get the proportion of beta cutoffs caused by the first move searched.
+        double firstMoveCutoffRate() const;
+        /// @brief Get the rate of playouts per second.
+        double playoutsPerSecond() const;
+
+        /// @brief Output the statistics in a human readable form.
+        void print(std::ostream &out) const;
+        /// @brief Output the statistics as a JSON object.
+        void printJson(std::ostream &out) const;
+
+    private:
+        typedef std::chrono::steady_clock clock;
+        clock::time_point searchStart;
+        clock::time_point iterationStart;
+        long long iterationStartNodes;
+
+        static double millisecondsSince(clock::time_point start);
+    };
+}
@@ -0,0 +1,133 @@
+#include "transpositiontable.h"
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ConnectFour
+{
+    TranspositionTable::TranspositionTable(int size) :
+        size(size),
+        buckets(size / bucketSize),
+        table(new BoardEvaluation[size]()),
+        snapshot(NULL),
+        snapshotBytes(0),
+        snapshotFile(-1),
+        snapshotSaved(false)
+    {
+        assert(size >= bucketSize && size % bucketSize == 0);
+    }
+
+    TranspositionTable::~TranspositionTable()
+    {
+        if (snapshot)
+        {
+            munmap(snapshot, snapshotBytes);
+            close(snapshotFile);
+        }
+        else
+        {
+            delete [] table;
+        }
+    }
+
+    void TranspositionTable::clear()
+    {
+        if (snapshotSaved) changeSnapshot();
+        std::memset(table, 0, size * sizeof(BoardEvaluation));
+    }
+
+    bool TranspositionTable::mapFile(const std::string &path)
+    {
+        static const char magic[8] = { 'C', '4', 'A', 'I', 'T', 'T', '\0', '\0' };
+        const std::size_t bytes = snapshotOffset + size * sizeof(BoardEvaluation);
+
+        int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd == -1) return false;
+        // The lock is held until the file is unmapped, so that another process can't change the same entries
+        if (flock(fd, LOCK_EX | LOCK_NB) == -1)
+        {
+            close(fd);
+            return false;
+        }
+        struct stat status;
+        bool sameSize = fstat(fd, &status) == 0 && status.st_size == static_cast<off_t>(bytes);
+        if (!sameSize && ftruncate(fd, bytes) == -1)
+        {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        SnapshotHeader *header = static_cast<SnapshotHeader *>(mapping);
+        BoardEvaluation *entries = reinterpret_cast<BoardEvaluation *>(static_cast<char *>(mapping) + snapshotOffset);
+        bool valid = sameSize &&
+            std::memcmp(header->magic, magic, sizeof(magic)) == 0 &&
+            header->version == snapshotVersion &&
+            header->keyBits == sizeof(Board::Hash) * 8 &&
+            header->entrySize == sizeof(BoardEvaluation) &&
+            header->size == static_cast<unsigned int>(size) &&
+            header->complete;
+        if (!valid)
+        {
+            // Truncating a larger file keeps the start of its entries, so the entries are always cleared
+            std::memset(entries, 0, size * sizeof(BoardEvaluation));
+            std::memcpy(header->magic, magic, sizeof(magic));
+            header->version = snapshotVersion;
+            header->keyBits = sizeof(Board::Hash) * 8;
+            header->entrySize = sizeof(BoardEvaluation);
+            header->size = size;
+        }
+        // The entries are about to change
+        header->complete = 0;
+
+        if (snapshot)
+        {
+            munmap(snapshot, snapshotBytes);
+            close(snapshotFile);
+        }
+        else
+        {
+            delete [] table;
+        }
+        snapshot = header;
+        snapshotBytes = bytes;
+        snapshotFile = fd;
+        snapshotSaved = false;
+        table = entries;
+        return true;
+    }
+
+    void TranspositionTable::saveSnapshot()
+    {
+        if (!snapshot) return;
+        snapshot->complete = 1;
+        snapshotSaved = true;
+        // Only schedule the write back, the next process reads the mapped pages from memory anyway
+        msync(snapshot, snapshotBytes, MS_ASYNC);
+    }
+
+    TranspositionTable::StoreResult TranspositionTable::store(const Board &board, int move, int value, int height, EvaluationType type)
+    {
+        if (snapshotSaved) changeSnapshot();
+        BoardEvaluation *bucket = const_cast<BoardEvaluation *>(bucketFor(board));
+        BoardEvaluation *eval = (height >= bucket[0].height || bucket[0].hash == board.getHash()) ? &bucket[0] : &bucket[1];
+
+        StoreResult result = (eval->height == 0 && eval->hash == 0) ? store_new : store_replaced;
+        // Store the move in the transposition table
+        eval->hash = board.getHash();
+        eval->move = move;
+        eval->value = value;
+        eval->height = height;
+        eval->type = type;
+        return result;
+    }
+}
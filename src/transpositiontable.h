@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @brief Enum for types of board evaluation
+    enum EvaluationType
+    {
+        evaluation_none = -1, // No value, the move is not playable
+        evaluation_exact = 0,
+        evaluation_belowAlpha = 1, // Value is an upper bound
+        evaluation_aboveBeta = 2 // Value is a lower bound
+    };
+
+    /// @brief Struct to store data about a board evaluation for future use
+    struct BoardEvaluation
+    {
+        Board::Hash hash;
+        int move; // Move determined to be best for current player
+        int value; // Minimax value for the position based on current player
+        int height; // Height of the subtree rooted at this position (depends on iteration)
+        EvaluationType type;
+    };
+
+    /// @class TranspositionTable
+    /// @brief Table of board evaluations indexed by board hash.
+    ///
+    /// Each hash maps to a bucket of two entries. The first keeps the evaluation with the greatest height, and
+    /// the second always takes the most recent evaluation that doesn't replace the first. Deep results survive
+    /// collisions, while fresh shallow results aren't discarded.
+    class TranspositionTable
+    {
+    public:
+        /// @brief Default number of entries: 2^18 - 5MB
+        static const int defaultSize = 262144;
+
+        /// @brief Number of entries in each bucket.
+        static const int bucketSize = 2;
+
+        /// @brief Result of storing an evaluation, for statistics.
+        enum StoreResult
+        {
+            store_new, // Stored in an empty entry
+            store_replaced // Collision where old value was replaced
+        };
+
+        explicit TranspositionTable(int size = defaultSize);
+        ~TranspositionTable();
+
+        /// @brief Remove all evaluations from the table.
+        void clear();
+
+        /// @brief Keep the entries in a memory mapped file instead, so that a later process can start with them.
+        ///        The file is loaded without copying if it holds a complete snapshot of a table of the same size,
+        ///        otherwise it is created or reset to an empty table. The file is locked while it is mapped, so
+        ///        only one process can use it at a time.
+        /// @return Whether the file was mapped, which fails if another process has it locked. The table is
+        ///         unchanged if it wasn't.
+        bool mapFile(const std::string &path);
+
+        /// @brief Mark the entries in the mapped file as a complete snapshot, to be loaded by a later mapFile.
+        ///        The file is marked incomplete again by the next store or clear, so that the entries of an
+        ///        interrupted search are never loaded. Does nothing if no file is mapped.
+        void saveSnapshot();
+
+        /// @brief Get a pointer to the table entry for the given board.
+        ///        The entry is for a different board unless its hash matches.
+        BoardEvaluation *entryFor(const Board &board)
+            { return const_cast<BoardEvaluation *>(static_cast<const TranspositionTable *>(this)->entryFor(board)); }
+        const BoardEvaluation *entryFor(const Board &board) const
+        {
+            const BoardEvaluation *bucket = bucketFor(board);
+            return (bucket[1].hash == board.getHash() && bucket[0].hash != board.getHash()) ? &bucket[1] : &bucket[0];
+        }
+
+        /// @brief Get a copy of the table entry for the given board, which is for a different board unless its
+        ///        hash matches. Searches read entries through this so that tables shared between threads can
+        ///        return a consistent copy.
+        BoardEvaluation lookup(const Board &board) const { return *entryFor(board); }
+
+        /// @brief Hint that the entry for the given board will be read soon, so that it can be loaded into the cache.
+        void prefetch(const Board &board) const
+        {
+#ifdef __GNUC__
+            __builtin_prefetch(bucketFor(board));
+#endif
+        }
+
+        /// @brief Store a board evaluation in the depth preferred entry if it is at least as high, or is for the
+        ///        same board, otherwise in the always replaced entry.
+        StoreResult store(const Board &board, int move, int value, int height, EvaluationType type);
+
+    private:
+        const int size;
+        const int buckets;
+        BoardEvaluation *table;
+
+        /// @brief Header at the start of a mapped file, identifying the table layout its entries were saved with.
+        struct SnapshotHeader
+        {
+            char magic[8];
+            unsigned int version;
+            unsigned int keyBits; // Width of Board::Hash
+            unsigned int entrySize;
+            unsigned int size;
+            unsigned int complete; // Non-zero once saveSnapshot is called, until the entries change
+        };
+
+        // Entries are aligned after the header in the file
+        static const std::size_t snapshotOffset = 64;
+        static const unsigned int snapshotVersion = 1;
+
+        // The mapped file, or null if the entries are allocated, and its locked descriptor
+        SnapshotHeader *snapshot;
+        std::size_t snapshotBytes;
+        int snapshotFile;
+        // Whether the mapped file is marked complete, kept here so that stores don't read the header
+        bool snapshotSaved;
+
+        // Mark the mapped file incomplete before its entries change
+        void changeSnapshot()
+        {
+            snapshot->complete = 0;
+            snapshotSaved = false;
+        }
+
+        const BoardEvaluation *bucketFor(const Board &board) const
+            { return &table[(board.getHash() % buckets) * bucketSize]; }
+
+        // Table owns its entries
+        TranspositionTable(const TranspositionTable &);
+        TranspositionTable &operator=(const TranspositionTable &);
+    };
+}
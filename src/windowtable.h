@@ -0,0 +1,85 @@
+#pragma once
+
+#include "board.h"
+
+namespace ConnectFour
+{
+    /// @brief Tables of the windows of four slots that a player can connect four in.
+    ///
+    /// Slots are indexed by row*Board::width + column, with row 0 at the bottom. There are 24 horizontal, 21
+    /// vertical and 24 diagonal windows, numbered in that order by windowSlot. The tables of the windows
+    /// containing each slot are computed from that numbering at compile time.
+    namespace WindowTable
+    {
+        constexpr int windowCount = 69;
+        constexpr int slotCount = Board::width*Board::height;
+        /// @brief The greatest number of windows that contain a single slot.
+        constexpr int maxSlotWindows = 13;
+
+        /// @brief Get a slot of a window.
+        /// @param window The window number. Horizontal windows are numbered by their row then left column,
+        ///        vertical windows by their column then bottom row, and each direction of diagonal by its bottom
+        ///        row then bottom column.
+        /// @param k The position of the slot in the window, from the left for horizontal and diagonal windows
+        ///        and from the bottom for vertical windows.
+        constexpr int windowSlot(int window, int k)
+        {
+            return window < 24 ? (window / 4) * Board::width + window % 4 + k
+                : window < 45 ? ((window - 24) % 3 + k) * Board::width + (window - 24) / 3
+                : window < 57 ? ((window - 45) / 4 + k) * Board::width + (window - 45) % 4 + k
+                : ((window - 57) / 4 + 3 - k) * Board::width + (window - 57) % 4 + k;
+        }
+
+        constexpr bool windowContains(int window, int slot)
+        {
+            return windowSlot(window, 0) == slot || windowSlot(window, 1) == slot
+                || windowSlot(window, 2) == slot || windowSlot(window, 3) == slot;
+        }
+
+        /// @brief Get the number of windows below the given one that contain a slot.
+        constexpr int countSlotWindows(int slot, int window = windowCount)
+        {
+            return window == 0 ? 0 : countSlotWindows(slot, window - 1) + (windowContains(window - 1, slot) ? 1 : 0);
+        }
+
+        /// @brief Get the window at an index in the list of windows containing a slot, starting from the given
+        ///        window, or windowCount past the end of the list.
+        constexpr int findSlotWindow(int slot, int index, int window = 0)
+        {
+            return window == windowCount ? windowCount
+                : !windowContains(window, slot) ? findSlotWindow(slot, index, window + 1)
+                : index == 0 ? window : findSlotWindow(slot, index - 1, window + 1);
+        }
+
+        // Expansion of the indices of the table entries, to compute each entry in an initializer
+        template <int... I> struct Indices {};
+        template <int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+        template <int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+        struct SlotWindowCounts { int values[slotCount]; };
+        struct SlotWindowLists { unsigned char values[slotCount][maxSlotWindows]; };
+
+        template <int... I>
+        constexpr SlotWindowCounts makeSlotWindowCounts(Indices<I...>)
+        {
+            return SlotWindowCounts{ { countSlotWindows(I)... } };
+        }
+
+        template <int... I>
+        constexpr SlotWindowLists makeSlotWindowLists(Indices<I...>)
+        {
+            return SlotWindowLists{ { static_cast<unsigned char>(findSlotWindow(I / maxSlotWindows, I % maxSlotWindows))... } };
+        }
+
+        constexpr SlotWindowCounts slotWindowCountTable = makeSlotWindowCounts(MakeIndices<slotCount>::type());
+        constexpr SlotWindowLists slotWindowTable = makeSlotWindowLists(MakeIndices<slotCount*maxSlotWindows>::type());
+
+        /// @brief Number of windows containing each slot.
+        static constexpr const int (&slotWindowCounts)[slotCount] = slotWindowCountTable.values;
+
+        /// @brief Windows containing each slot, padded with windowCount.
+        static constexpr const unsigned char (&slotWindows)[slotCount][maxSlotWindows] = slotWindowTable.values;
+
+        static_assert(countSlotWindows(3*Board::width + 3) == maxSlotWindows, "A centre slot is in the most windows");
+    }
+}